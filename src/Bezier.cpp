@@ -6,15 +6,24 @@
 #include <qline.h>
 #include <qnamespace.h>
 
-BezierModel::BezierModel(geometry::CubicBezier *bezier) : m_bezier(bezier) {}
+BezierModel::BezierModel(geometry::CubicBezier *bezier)
+    : m_curve(bezier), m_bezier(bezier) {}
+
+BezierModel::BezierModel(geometry::QuinticBezier *bezier) : m_curve(bezier) {}
+
+bool BezierModel::editable() const { return m_bezier != nullptr; }
 
 std::array<Point, 4> BezierModel::endpoints() const {
   return m_bezier->getControlPoints();
 }
 
+const geometry::Polyline &BezierModel::polyline(Length tolerance) const {
+  return geometry::flattened<float>(*m_curve, tolerance);
+}
+
 void BezierModel::setEndpoints(const std::array<Point, 4> &endpoints) {
   // only emit if changed, prevents infinite loop
-  if (m_bezier->getControlPoints() == endpoints) {
+  if (!m_bezier || m_bezier->getControlPoints() == endpoints) {
     return;
   }
   m_bezier->updateBezierEndpoints(endpoints);
@@ -24,12 +33,10 @@ void BezierModel::setEndpoints(const std::array<Point, 4> &endpoints) {
 
 BezierView::BezierView(BezierModel *model, FieldView *fieldView,
                        BezierElementProperties properties)
-    : QObject(nullptr), m_model(model), m_fieldView(fieldView) {
-
-  auto endpoints = model->endpoints();
-  auto newEndpoints = endpointsToScene(endpoints);
+    : QObject(nullptr), m_model(model), m_fieldView(fieldView),
+      m_properties(properties) {
 
-  auto path = createPath(endpoints);
+  auto path = createPath();
   item = new QGraphicsPathItem(path);
 
   item->setBrush(Qt::NoBrush);
@@ -38,6 +45,16 @@ BezierView::BezierView(BezierModel *model, FieldView *fieldView,
   item->setZValue(5);
   m_fieldView->getScene()->addItem(item);
 
+  connect(m_model, &BezierModel::endpointsChanged, this,
+          &BezierView::onModelChanged);
+
+  // only cubics have handles
+  if (!model->editable())
+    return;
+
+  auto endpoints = model->endpoints();
+  auto newEndpoints = endpointsToScene(endpoints);
+
   auto first_line = QLineF(newEndpoints.at(0), newEndpoints.at(1));
   auto second_line = QLineF(newEndpoints.at(2), newEndpoints.at(3));
 
@@ -46,9 +63,6 @@ BezierView::BezierView(BezierModel *model, FieldView *fieldView,
   control_line_items[1] = m_fieldView->getScene()->addLine(
       second_line, QPen(Qt::red, 2, Qt::DashLine));
 
-  connect(m_model, &BezierModel::endpointsChanged, this,
-          &BezierView::onModelChanged);
-
   // TODO: add lines that make it easier to differentiate control points
 
   // add every endpoint as
@@ -82,11 +96,15 @@ BezierView::endpointsToScene(std::array<Point, 4> endpoints) {
   return newEndpoints;
 }
 
-QPainterPath BezierView::createPath(std::array<Point, 4> endpoints) {
-  auto newEndpoints = endpointsToScene(endpoints);
-  QPainterPath path(newEndpoints.at(0));
+QPainterPath BezierView::createPath() {
+  // draws the cached polyline so Qt doesn't re-flatten the curve every paint
+  const geometry::Polyline &polyline =
+      m_model->polyline(m_properties.flatteningTolerance);
 
-  path.cubicTo(newEndpoints.at(1), newEndpoints.at(2), newEndpoints.at(3));
+  QPainterPath path(m_fieldView->fieldToScene(polyline.points.point(0)));
+  for (size_t i = 1; i < polyline.size(); i++) {
+    path.lineTo(m_fieldView->fieldToScene(polyline.points.point(i)));
+  }
 
   return path;
 }
@@ -119,7 +137,7 @@ QGraphicsPathItem *BezierView::graphicsItem() const { return item; }
 
 void BezierView::onModelChanged(const std::array<Point, 4> &endpoints) {
   drawControlLines(endpoints);
-  item->setPath(createPath(endpoints));
+  item->setPath(createPath());
 }
 
 void BezierView::onItemChanged(const QPointF &scene_endpoint, int index) {
@@ -6,6 +6,8 @@
 #include "utils.h"
 
 #include "geometry/Bezier.h"
+#include "geometry/Flatten.h"
+#include "geometry/QuinticBezier.h"
 #include <QColor>
 #include <QHBoxLayout>
 #include <QLabel>
@@ -18,6 +20,8 @@
 struct BezierElementProperties {
   Length strokeWidth = 1_in;
   Length controlPointRadius = 4_in;
+  // maximum distance between the drawn polyline and the curve
+  Length flatteningTolerance = 0.05_in;
   QColor pathColor = Qt::green;
   QColor controlPointColor = QColor(255, 0, 0, 127);
   bool movable = true;
@@ -27,7 +31,14 @@ class BezierModel : public QObject, public ElementModel {
   Q_OBJECT
 public:
   BezierModel(geometry::CubicBezier *bezier);
+  // drawn like a cubic, but without drag handles
+  BezierModel(geometry::QuinticBezier *bezier);
+  // whether the control points can be dragged and edited, cubics only
+  bool editable() const;
+  // control points of a cubic, only valid if editable()
   std::array<Point, 4> endpoints() const;
+  // flattened curve, cached until the endpoints change
+  const geometry::Polyline &polyline(Length tolerance) const;
 
 public slots:
   void setEndpoints(const std::array<Point, 4> &endpoints);
@@ -36,7 +47,10 @@ signals:
   void endpointsChanged(const std::array<Point, 4> &endpoints);
 
 private:
-  geometry::CubicBezier *m_bezier;
+  // curve that is drawn
+  Curve *m_curve;
+  // the same curve if it is a cubic, which the handles edit
+  geometry::CubicBezier *m_bezier = nullptr;
 };
 
 class BezierView : public QObject, public ElementView {
@@ -48,7 +62,7 @@ public:
   ~BezierView() override;
 
   std::array<QPointF, 4> endpointsToScene(std::array<Point, 4> endpoints);
-  QPainterPath createPath(std::array<Point, 4> endpoints);
+  QPainterPath createPath();
   void drawControlLines(std::array<Point, 4> endpoints);
 
   QGraphicsPathItem *graphicsItem() const;
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Curve.h"
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+
+namespace geometry {
+
+/**
+ * @brief walks along a curve while keeping track of the distance travelled
+ *
+ * Calling s(t) on a curve integrates from the start every time, so stepping
+ * through a curve with it is quadratic in the number of steps. The cursor
+ * instead carries the current time and cumulative arc length, and each step
+ * only integrates over the newly covered interval.
+ */
+template <std::floating_point Float> class BasicArcLengthCursor {
+public:
+  using CurveType = BasicCurve<Float>;
+  using LengthType = typename CurveType::LengthType;
+  using PointType = typename CurveType::PointType;
+
+  /**
+   * @brief creates a cursor on curve at time t
+   *
+   * @param curve curve to walk, must outlive the cursor
+   * @param t starting time
+   */
+  BasicArcLengthCursor(CurveType &curve, Float t = 0) : m_curve(&curve) {
+    reset(t);
+  }
+
+  // moves the cursor to time t, integrating from the start of the curve once
+  void reset(Float t = 0) {
+    m_t = std::clamp(t, Float(0), Float(1));
+    m_s = m_t == 0 ? LengthType(0.0) : m_curve->s(m_t);
+  }
+
+  Float t() const { return m_t; }
+
+  // distance along the curve from t = 0 to the cursor
+  LengthType s() const { return m_s; }
+
+  bool atStart() const { return m_t <= 0; }
+  bool atEnd() const { return m_t >= 1; }
+
+  PointType point() const { return m_curve->f(m_t); }
+
+  CurveType &curve() const { return *m_curve; }
+
+  /**
+   * @brief advances the cursor by a time step
+   *
+   * @param dt time step, may be negative. The cursor stops at the curve ends
+   */
+  void advance_t(Float dt) {
+    const Float next = std::clamp(m_t + dt, Float(0), Float(1));
+    m_s += m_curve->s(m_t, next);
+    m_t = next;
+  }
+
+  /**
+   * @brief advances the cursor by a distance along the curve
+   *
+   * Uses Newton's method on the arc length of the interval between the
+   * current and the new time. Every correction adds the arc length of the
+   * stretch it moved across, so only that interval is integrated.
+   *
+   * @param ds distance to travel, may be negative. The cursor stops at the
+   * curve ends
+   */
+  void advance_s(LengthType ds) {
+    if (ds.internal() == 0)
+      return;
+
+    // the distance left to either end is known from the cumulative length,
+    // so steps never integrate past the new time
+    const Float limit = ds.internal() > 0 ? 1 : 0;
+    LengthType travelled =
+        ds.internal() > 0 ? m_curve->total_distance() - m_s : -m_s;
+    if (units::abs(travelled) <= units::abs(ds)) {
+      m_s += travelled;
+      m_t = limit;
+      return;
+    }
+
+    const LengthType tol = LengthType(in * 1e-4);
+    constexpr int maxIter = 8;
+
+    const Float lo = std::min(m_t, limit);
+    const Float hi = std::max(m_t, limit);
+    Float next = std::clamp(m_t + first_step(ds, limit), lo, hi);
+
+    // each correction only integrates the short stretch it moves across
+    travelled = m_curve->s(m_t, next);
+    for (int i = 0; i < maxIter; i++) {
+      LengthType error = travelled - ds;
+      if (units::abs(error) < tol)
+        break;
+
+      const LengthType speed = m_curve->df(next).magnitude();
+      if (speed.internal() <= 1e-6)
+        break;
+
+      const Float corrected = std::clamp(next - Float(error / speed), lo, hi);
+      travelled += m_curve->s(next, corrected);
+      next = corrected;
+    }
+
+    m_s += travelled;
+    m_t = next;
+  }
+
+private:
+  // time step covering ds, from the series reversion of the third order
+  // expansion of s(t). Short steps usually land within tolerance without any
+  // Newton correction
+  Float first_step(LengthType ds, Float limit) const {
+    const PointType d = m_curve->df(m_t);
+    const PointType dd = m_curve->ddf(m_t);
+    const PointType ddd = m_curve->dddf(m_t);
+    const Float dx = d.x.internal(), dy = d.y.internal();
+    const Float v = std::hypot(dx, dy);
+    if (v <= Float(1e-6))
+      return (limit - m_t) / 2;
+
+    // first and second derivative of the speed
+    const Float ddx = dd.x.internal(), ddy = dd.y.internal();
+    const Float a = (dx * ddx + dy * ddy) / v;
+    const Float jerk = (ddx * ddx + ddy * ddy + dx * ddd.x.internal() +
+                        dy * ddd.y.internal() - a * a) /
+                       v;
+    const Float u = ds.internal() / v;
+    return u - a * u * u / (2 * v) +
+           (3 * a * a - v * jerk) * u * u * u / (6 * v * v);
+  }
+
+  CurveType *m_curve;
+  Float m_t;
+  LengthType m_s;
+};
+
+using ArcLengthCursor = BasicArcLengthCursor<float>;
+using DArcLengthCursor = BasicArcLengthCursor<double>;
+
+} // namespace geometry
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "../utils.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+
+namespace geometry {
+
+/**
+ * @brief cumulative arc length and speed of a curve at uniformly spaced times
+ *
+ * Shared by the polynomial curves. The curve passes in its speed and an
+ * integrator for the arc length between two times, so the table works with
+ * whatever integration method the curve is configured with.
+ *
+ * @tparam Float scalar type of the curve
+ */
+template <std::floating_point Float> class ArcLengthTable {
+public:
+  using LengthType = Named<Length::Other<Float>>;
+
+  static constexpr size_t size = 32;
+  static constexpr Float dt = Float(1) / size;
+
+  /**
+   * @brief integrates the curve interval by interval
+   *
+   * @param speed called with a time, returns the speed as a LengthType
+   * @param arc_length called with two times, returns the distance between
+   */
+  template <typename Speed, typename ArcLength>
+  void build(Speed &&speed, ArcLength &&arc_length) {
+    m_s[0] = LengthType(0.0);
+    m_speed[0] = speed(Float(0));
+    for (size_t i = 1; i <= size; i++) {
+      m_s[i] = m_s[i - 1] + arc_length((i - 1) * dt, i * dt);
+      m_speed[i] = speed(i * dt);
+    }
+  }
+
+  // length of the whole curve
+  LengthType total() const { return m_s[size]; }
+
+  // distance at the start of interval i
+  LengthType start(size_t i) const { return m_s[i]; }
+
+  // index of the tabulated time at or before t
+  static size_t interval(Float t) {
+    return std::min(static_cast<size_t>(std::max(t, Float(0)) * size),
+                    size - 1);
+  }
+
+  /**
+   * @brief distance at time t
+   *
+   * Only integrates from the closest tabulated time before t.
+   */
+  template <typename ArcLength>
+  LengthType s(Float t, ArcLength &&arc_length) const {
+    const size_t i = interval(t);
+    return m_s[i] + arc_length(i * dt, t);
+  }
+
+  /**
+   * @brief time by distance
+   *
+   * Binary searches the interval containing the target, interpolates t(s)
+   * within it and finishes with a single Newton step.
+   */
+  template <typename Speed, typename ArcLength>
+  Float t_by_s(LengthType target, Speed &&speed, ArcLength &&arc_length) const {
+    if (target <= LengthType(0.0))
+      return 0;
+    if (target >= total())
+      return 1;
+
+    // finds the table interval containing the target
+    auto upper = std::upper_bound(m_s.begin(), m_s.end(), target);
+    const size_t i =
+        std::clamp<size_t>(upper - m_s.begin(), 1, size) - 1;
+
+    const Float t0 = i * dt;
+    const LengthType ds = m_s[i + 1] - m_s[i];
+    if (ds.internal() <= 0)
+      return t0;
+
+    // monotone cubic hermite interpolation of t(s) over the interval, in
+    // coordinates normalized so the secant slope is 1. Slopes are dt/ds,
+    // limited as in Fritsch-Carlson so the interpolant can't overshoot
+    const Float u = (target - m_s[i]) / ds;
+    const LengthType secant_speed = ds / dt;
+    Float m0 = 3, m1 = 3;
+    if (m_speed[i] * 3 > secant_speed)
+      m0 = secant_speed / m_speed[i];
+    if (m_speed[i + 1] * 3 > secant_speed)
+      m1 = secant_speed / m_speed[i + 1];
+    const Float norm = m0 * m0 + m1 * m1;
+    if (norm > 9) {
+      const Float scale = 3 / std::sqrt(norm);
+      m0 *= scale;
+      m1 *= scale;
+    }
+
+    const Float u2 = u * u;
+    const Float u3 = u2 * u;
+    const Float h = (u3 - 2 * u2 + u) * m0 + (-2 * u3 + 3 * u2) +
+                    (u3 - u2) * m1;
+    Float t = t0 + h * dt;
+
+    // single Newton polish, only integrating inside the interval
+    const LengthType speed_t = speed(t);
+    if (speed_t.internal() > 1e-6) {
+      const LengthType error = m_s[i] + arc_length(t0, t) - target;
+      t -= error / speed_t;
+    }
+
+    return std::clamp(t, t0, t0 + dt);
+  }
+
+private:
+  std::array<LengthType, size + 1> m_s;
+  std::array<LengthType, size + 1> m_speed;
+};
+
+} // namespace geometry
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "Bounds.h"
+#include "Curve.h"
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief bounding volume hierarchy over pieces of one or more curves
+ *
+ * Every curve is split into a number of equal time ranges, each with tight
+ * bounds, and the pieces are arranged in a binary tree of boxes. Box queries
+ * then only visit the pieces whose bounds overlap, which makes hover tests
+ * and collision broad phases cheap for scenes with hundreds of segments.
+ *
+ * The tree stores pointers to the curves it was built from and has to be
+ * rebuilt after any of them changes.
+ *
+ * @tparam Float scalar type of the curves
+ */
+template <std::floating_point Float> class BasicBVH {
+public:
+  using CurveType = BasicCurve<Float>;
+  using Box = BasicBox<Float>;
+
+  // time range of a curve
+  struct Piece {
+    CurveType *curve;
+    // index of the curve in the span the tree was built from
+    size_t curve_index;
+    Float t0;
+    Float t1;
+    Box box;
+  };
+
+  BasicBVH() = default;
+
+  BasicBVH(std::span<CurveType *const> curves, size_t pieces_per_curve = 4) {
+    build(curves, pieces_per_curve);
+  }
+
+  /**
+   * @brief rebuilds the tree over the given curves
+   *
+   * @param curves curves to index, must outlive the tree
+   * @param pieces_per_curve number of time ranges each curve is split into
+   */
+  void build(std::span<CurveType *const> curves, size_t pieces_per_curve = 4) {
+    m_pieces.clear();
+    m_nodes.clear();
+    pieces_per_curve = std::max<size_t>(pieces_per_curve, 1);
+
+    for (size_t i = 0; i < curves.size(); i++) {
+      for (size_t j = 0; j < pieces_per_curve; j++) {
+        const Float t0 = Float(j) / pieces_per_curve;
+        const Float t1 = Float(j + 1) / pieces_per_curve;
+        m_pieces.push_back(
+            {curves[i], i, t0, t1, curves[i]->bounds(t0, t1)});
+      }
+    }
+
+    if (!m_pieces.empty()) {
+      m_nodes.reserve(2 * m_pieces.size());
+      m_nodes.resize(1);
+      build_node(0, 0, m_pieces.size());
+    }
+  }
+
+  size_t size() const { return m_pieces.size(); }
+
+  bool empty() const { return m_pieces.empty(); }
+
+  // bounds of everything in the tree
+  Box bounds() const { return m_nodes.empty() ? Box{} : m_nodes[0].box; }
+
+  /**
+   * @brief calls visit with every piece whose bounds overlap box
+   *
+   * @param box query box in internal units
+   * @param visit called with a const Piece &
+   */
+  template <typename F> void query(const Box &box, F &&visit) const {
+    if (m_nodes.empty())
+      return;
+
+    // explicit stack, the tree depth is logarithmic in the piece count
+    uint32_t stack[64];
+    size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+      const Node &node = m_nodes[stack[--top]];
+      if (!node.box.intersects(box))
+        continue;
+
+      if (node.count > 0) {
+        for (uint32_t i = node.first; i < node.first + node.count; i++) {
+          if (m_pieces[i].box.intersects(box))
+            visit(m_pieces[i]);
+        }
+      } else {
+        stack[top++] = node.first;
+        stack[top++] = node.first + 1;
+      }
+    }
+  }
+
+  /**
+   * @brief calls visit with every piece that may lie within radius of a point
+   *
+   * @param x point x in internal units
+   * @param y point y in internal units
+   * @param radius search radius in internal units
+   * @param visit called with a const Piece &
+   */
+  template <typename F>
+  void query(Float x, Float y, Float radius, F &&visit) const {
+    const Float radius2 = radius * radius;
+    query(Box{x - radius, y - radius, x + radius, y + radius},
+          [&](const Piece &piece) {
+            if (piece.box.distance2(x, y) <= radius2)
+              visit(piece);
+          });
+  }
+
+  // pieces whose bounds overlap box
+  std::vector<const Piece *> query(const Box &box) const {
+    std::vector<const Piece *> result;
+    query(box, [&result](const Piece &piece) { result.push_back(&piece); });
+    return result;
+  }
+
+private:
+  // leaves have a count of pieces starting at first, inner nodes have a
+  // count of 0 and their children at first and first + 1
+  struct Node {
+    Box box;
+    uint32_t first;
+    uint32_t count;
+  };
+
+  static constexpr size_t max_leaf_size = 2;
+
+  std::vector<Piece> m_pieces;
+  std::vector<Node> m_nodes;
+
+  // fills the already allocated node at index with pieces [begin, end)
+  void build_node(uint32_t index, size_t begin, size_t end) {
+    Box box, centers;
+    for (size_t i = begin; i < end; i++) {
+      box.expand(m_pieces[i].box);
+      centers.expand(m_pieces[i].box.center_x(), m_pieces[i].box.center_y());
+    }
+    m_nodes[index].box = box;
+
+    if (end - begin <= max_leaf_size) {
+      m_nodes[index].first = begin;
+      m_nodes[index].count = end - begin;
+      return;
+    }
+
+    // median split along the axis the piece centers spread out the most
+    const bool split_x = centers.width() >= centers.height();
+    const size_t mid = (begin + end) / 2;
+    std::nth_element(m_pieces.begin() + begin, m_pieces.begin() + mid,
+                     m_pieces.begin() + end,
+                     [split_x](const Piece &a, const Piece &b) {
+                       return split_x ? a.box.center_x() < b.box.center_x()
+                                      : a.box.center_y() < b.box.center_y();
+                     });
+
+    // children are allocated next to each other so inner nodes only need
+    // the index of the first one
+    const uint32_t children = m_nodes.size();
+    m_nodes.resize(m_nodes.size() + 2);
+    m_nodes[index].first = children;
+    m_nodes[index].count = 0;
+
+    build_node(children, begin, mid);
+    build_node(children + 1, mid, end);
+  }
+};
+
+using BVH = BasicBVH<float>;
+using DBVH = BasicBVH<double>;
+
+} // namespace geometry
@@ -0,0 +1,478 @@
+#pragma once
+
+#include "ArcLengthTable.h"
+#include "Curve.h"
+#include "Polynomial.h"
+#include "Quadrature.h"
+#include "Samples.h"
+#include "Split.h"
+#include "units/Vector2D.hpp"
+#include "units/units.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <span>
+#include <utility>
+
+namespace geometry {
+
+/**
+ * @brief everything a bezier curve does that only depends on its degree
+ *
+ * Derived curves supply their control points through the constructor and
+ * their basis matrix, which turns control points into polynomial
+ * coefficients, as a static constexpr basis_matrix with rows ordered from
+ * the highest power of t. Evaluation, batch sampling, arc length, bounds and
+ * splitting are shared.
+ *
+ * The overrides are final, so calls between them are devirtualized like in
+ * the final curve types.
+ *
+ * @tparam Float scalar type, float or double
+ * @tparam N number of control points
+ * @tparam Derived the curve type, returned by split() and trim()
+ */
+template <std::floating_point Float, size_t N, typename Derived>
+class BasicBezier : public BasicCurve<Float> {
+  static_assert(N >= 4, "beziers need at least a third derivative");
+
+public:
+  using Base = BasicCurve<Float>;
+  using typename Base::Box;
+  using typename Base::CurvatureType;
+  using typename Base::LengthType;
+  using typename Base::PointType;
+  using typename Base::Samples;
+
+  using Base::bounds;
+  using Base::endpoints;
+
+private:
+  using Base::m_integration;
+  using Base::m_integration_cost;
+
+  // coefficient matrices of the curve and its derivatives, stored in the
+  // curve's scalar type, rows ordered from the highest power of t
+  std::array<PointType, N> coeff_matrix;
+  std::array<PointType, N - 1> der_coeff_matrix;
+  std::array<PointType, N - 2> second_der_coeff_matrix;
+  std::array<PointType, N - 3> third_der_coeff_matrix;
+
+  // squared speed, in m^2 and highest power first
+  std::array<Float, 2 * N - 3> speed_squared_coeffs;
+
+  // control points between the endpoints
+  std::array<Point, N - 2> m_controls;
+
+  // coefficients of the derivative of a polynomial, highest power first
+  template <size_t M>
+  static std::array<Point, M - 1> derivative(const std::array<Point, M> &c) {
+    std::array<Point, M - 1> result;
+    for (size_t i = 0; i + 1 < M; i++) {
+      result[i] = c[i] * double(M - 1 - i);
+    }
+    return result;
+  }
+
+  template <size_t M>
+  static void store(const std::array<Point, M> &from,
+                    std::array<PointType, M> &to) {
+    for (size_t i = 0; i < M; i++) {
+      to[i] = PointType(from[i]);
+    }
+  }
+
+  // derivatives are taken in double, before rounding to the scalar type
+  void compute_coefficient_matrices() {
+    const std::array<Point, N> points = getControlPoints();
+    std::array<Point, N> coefficients;
+    for (size_t i = 0; i < N; i++) {
+      Point sum = points[0] * Derived::basis_matrix[i][0];
+      for (size_t j = 1; j < N; j++) {
+        sum = sum + points[j] * Derived::basis_matrix[i][j];
+      }
+      coefficients[i] = sum;
+    }
+    const std::array<Point, N - 1> first = derivative(coefficients);
+    const std::array<Point, N - 2> second = derivative(first);
+    store(coefficients, coeff_matrix);
+    store(first, der_coeff_matrix);
+    store(second, second_der_coeff_matrix);
+    store(derivative(second), third_der_coeff_matrix);
+
+    std::array<Float, N - 1> dx, dy;
+    for (size_t i = 0; i < der_coeff_matrix.size(); i++) {
+      dx[i] = der_coeff_matrix[i].x.internal();
+      dy[i] = der_coeff_matrix[i].y.internal();
+    }
+    speed_squared_coeffs = geometry::squared_norm(dx, dy);
+  }
+
+  // speed at t in m/s, from the cached polynomial instead of unit typed
+  // vector math, since it is what the quadrature loops evaluate
+  Float speed_internal(Float t) const {
+    // rounding can take the polynomial slightly below zero where the curve
+    // stops
+    return std::sqrt(std::max(geometry::horner(speed_squared_coeffs, t),
+                              Float(0)));
+  }
+
+  // evaluates a coefficient matrix at t
+  template <size_t M>
+  static PointType horner(const std::array<PointType, M> &coefficients,
+                          Float t) {
+    PointType result = coefficients[0];
+    for (size_t i = 1; i < M; i++) {
+      result = result * t + coefficients[i];
+    }
+    return result;
+  }
+
+  // arc length table, cumulative distance and speed at uniformly spaced times
+  bool m_use_arc_table = true;
+  geometry::VersionedCache<ArcLengthTable<Float>> m_arc_table;
+
+  // arc length between times a and b
+  LengthType arc_length(Float a, Float b) {
+    // the curve tolerance is shared out in proportion to the interval
+    return arc_length(a, b, m_integration.tolerance * std::abs(b - a));
+  }
+
+  LengthType arc_length(Float a, Float b, Float tolerance) {
+    auto speed_at = [this](Float t) { return speed_internal(t); };
+    return LengthType(geometry::integrate(speed_at, a, b, m_integration,
+                                          tolerance, m_integration_cost));
+  }
+
+  /**
+   * @brief length of the part between times a and b, as the part would
+   * integrate it itself
+   *
+   * The part's time is an affine map of this curve's, so integrating this
+   * curve over the images of the part's table intervals, at the part's
+   * tolerance per interval, repeats the part's own integration without
+   * building it first.
+   */
+  LengthType part_length(Float a, Float b) {
+    if (!m_use_arc_table)
+      return units::abs(arc_length(a, b, m_integration.tolerance));
+
+    constexpr size_t size = ArcLengthTable<Float>::size;
+    const Float step = (b - a) / size;
+    const Float tolerance = m_integration.tolerance * ArcLengthTable<Float>::dt;
+    LengthType length(0.0);
+    for (size_t i = 0; i < size; i++) {
+      length += arc_length(a + i * step, i + 1 == size ? b : a + (i + 1) * step,
+                           tolerance);
+    }
+    return units::abs(length);
+  }
+
+  // arc length table, rebuilt on first use after the curve changed
+  const ArcLengthTable<Float> &arc_table() {
+    return m_arc_table.get(this->version(), [this] {
+      ArcLengthTable<Float> table;
+      table.build([this](Float t) { return speed(t); },
+                  [this](Float a, Float b) { return arc_length(a, b); });
+      return table;
+    });
+  }
+
+  LengthType compute_total_distance() override {
+    if (!m_use_arc_table)
+      return arc_length(0, 1);
+    return arc_table().total();
+  }
+
+  // curve with this one's settings and an already known length
+  Derived part(const std::array<Point, N> &controls, LengthType length) const {
+    Derived curve(controls);
+    BasicBezier &bezier = curve;
+    bezier.m_integration = m_integration;
+    bezier.m_use_arc_table = m_use_arc_table;
+    bezier.seed_total_distance(length);
+    return curve;
+  }
+
+protected:
+  BasicBezier(const std::array<Point, N> &controls)
+      : Base(controls[0], controls[N - 1]) {
+    std::copy(controls.begin() + 1, controls.end() - 1, m_controls.begin());
+    compute_coefficient_matrices();
+  }
+
+public:
+  /**
+   * @brief sample bezier at sample time t
+   *
+   * @param t time at which to sample
+   * @return bezier point at time t
+   */
+  PointType f(Float t) final { return horner(coeff_matrix, t); }
+
+  /**
+   * @brief sample derivative of bezier at sample time t
+   *
+   * @param t time at which to sample
+   * @return derivative of bezier at time t
+   */
+  PointType df(Float t) final { return horner(der_coeff_matrix, t); }
+
+  PointType ddf(Float t) final { return horner(second_der_coeff_matrix, t); }
+
+  PointType dddf(Float t) final { return horner(third_der_coeff_matrix, t); }
+
+  /**
+   * @brief sample bezier at every time in t using Horner evaluation of the
+   * coefficient matrix
+   *
+   * @param t times at which to sample
+   * @param out buffer resized to t.size() and filled with positions
+   */
+  void f_batch(std::span<const Float> t, Samples &out) final {
+    out.resize(t.size());
+    geometry::horner_batch(coeff_matrix, t, out.x.data(), out.y.data());
+  }
+
+  /**
+   * @brief sample derivative of bezier at every time in t
+   *
+   * @param t times at which to sample
+   * @param out buffer resized to t.size() and filled with derivatives
+   */
+  void df_batch(std::span<const Float> t, Samples &out) final {
+    out.resize(t.size());
+    geometry::horner_batch(der_coeff_matrix, t, out.x.data(), out.y.data());
+  }
+
+  /**
+   * @brief sample second derivative of bezier at every time in t
+   *
+   * @param t times at which to sample
+   * @param out buffer resized to t.size() and filled with second derivatives
+   */
+  void ddf_batch(std::span<const Float> t, Samples &out) final {
+    out.resize(t.size());
+    geometry::horner_batch(second_der_coeff_matrix, t, out.x.data(),
+                           out.y.data());
+  }
+
+  /**
+   * @brief sample bezier at n uniformly spaced times by forward differencing
+   *
+   * @param t0 first time
+   * @param t1 last time, included
+   * @param n number of samples
+   * @param out buffer resized to n and filled with positions
+   */
+  void f_uniform(Float t0, Float t1, size_t n, Samples &out) final {
+    out.resize(n);
+    geometry::forward_difference_batch(coeff_matrix, t0,
+                                       Base::uniform_step(t0, t1, n), n,
+                                       out.x.data(), out.y.data());
+  }
+
+  /**
+   * @brief sample derivative of bezier at n uniformly spaced times
+   *
+   * @param t0 first time
+   * @param t1 last time, included
+   * @param n number of samples
+   * @param out buffer resized to n and filled with derivatives
+   */
+  void df_uniform(Float t0, Float t1, size_t n, Samples &out) final {
+    out.resize(n);
+    geometry::forward_difference_batch(der_coeff_matrix, t0,
+                                       Base::uniform_step(t0, t1, n), n,
+                                       out.x.data(), out.y.data());
+  }
+
+  /**
+   * @brief returns speed of bezier at time t
+   *
+   * @param t time at which to sample
+   * @return magnitude of derivative as a Length
+   */
+  LengthType speed(Float t) { return LengthType(speed_internal(t)); }
+
+  // curvature at t (Sprunk 12)
+  CurvatureType c(Float t) final { return c(t, df(t)); }
+
+  // curvature at t (Sprunk 12)
+  CurvatureType c(Float t, PointType df_t) final {
+    PointType second_derivative = ddf(t);
+
+    // speed function not used to avoid duplicate call to df()
+    Exponentiated<LengthType, std::ratio<3>> speed_cubed =
+        units::pow<3>(df_t.magnitude());
+
+    // avoids dividing by zero
+    if (speed_cubed.internal() < 1e-6)
+      return CurvatureType(0.0);
+
+    return df_t.cross(second_derivative) / speed_cubed;
+  }
+
+  LengthType s(Float t) final {
+    if (!m_use_arc_table)
+      return arc_length(0, t);
+
+    return arc_table().s(
+        t, [this](Float a, Float b) { return arc_length(a, b); });
+  }
+
+  LengthType s(Float t0, Float t1) final {
+    // long intervals are cheaper and more accurate through the table
+    if (m_use_arc_table && std::abs(t1 - t0) > ArcLengthTable<Float>::dt)
+      return s(t1) - s(t0);
+    return arc_length(t0, t1);
+  }
+
+  // gets time by distance
+  Float t_by_s(LengthType target, Float t_guess) final {
+    // the table lookup is already close enough that no guess is needed
+    if (m_use_arc_table)
+      return arc_table().t_by_s(
+          target, [this](Float t) { return speed(t); },
+          [this](Float a, Float b) { return arc_length(a, b); });
+
+    // uses Netwon method to find time from arc length
+    // This implementation is heavily based on vmplib:
+    // https://github.com/SerrialError/vmplib/blob/main/src/bezier.cpp
+
+    const LengthType tol = LengthType(in * 1e-2);
+    constexpr int max_iter = 20;
+    for (int i = 0; i < max_iter; i++) {
+      const LengthType error = s(t_guess) - target;
+      if (units::abs(error) < tol)
+        break;
+
+      t_guess -= error / speed(t_guess);
+      t_guess = std::clamp(t_guess, Float(0), Float(1));
+    }
+    return t_guess;
+  }
+
+  Float t_by_s(LengthType target) final {
+    // uses a starting guess of t = 0.5
+    return t_by_s(target, 0.5);
+  }
+
+  /**
+   * @brief exact axis aligned bounds of the bezier between times t0 and t1
+   *
+   * Each coordinate is extreme either at the ends of the interval or where
+   * its derivative has a root.
+   *
+   * @param t0 start time
+   * @param t1 end time
+   * @return box in internal units
+   */
+  Box bounds(Float t0, Float t1) final {
+    Box box;
+    for (Float t : {t0, t1}) {
+      const PointType p = f(t);
+      box.expand(p.x.internal(), p.y.internal());
+    }
+
+    const Float lo = std::min(t0, t1);
+    const Float hi = std::max(t0, t1);
+    std::array<Float, N - 1> dx, dy;
+    for (size_t i = 0; i + 1 < N; i++) {
+      dx[i] = der_coeff_matrix[i].x.internal();
+      dy[i] = der_coeff_matrix[i].y.internal();
+    }
+    std::array<Float, N - 2> roots;
+    for (const std::array<Float, N - 1> *coordinate : {&dx, &dy}) {
+      const size_t count = geometry::solve_polynomial(*coordinate, lo, hi,
+                                                      roots);
+      for (size_t i = 0; i < count; i++) {
+        const PointType p = f(roots[i]);
+        box.expand(p.x.internal(), p.y.internal());
+      }
+    }
+    return box;
+  }
+
+  /**
+   * @brief enables or disables the cached arc length table
+   *
+   * With the table enabled, s() only integrates from the closest tabulated
+   * time and t_by_s() is a binary search plus a single Newton step. Disabling
+   * it falls back to integrating from t = 0 and iterating Newton's method.
+   *
+   * @param enabled whether to build and use the table
+   */
+  void setArcLengthTable(bool enabled) {
+    m_use_arc_table = enabled;
+    this->invalidate_total_distance();
+  }
+
+  bool usesArcLengthTable() const { return m_use_arc_table; }
+
+  void setIntegration(geometry::Integration integration) final {
+    Base::setIntegration(integration);
+    m_arc_table.invalidate();
+  }
+
+  void updateBezierEndpoints(std::array<Point, N> new_controls) {
+    this->updateCurveEndpoints(new_controls[0], new_controls[N - 1]);
+    std::copy(new_controls.begin() + 1, new_controls.end() - 1,
+              m_controls.begin());
+    compute_coefficient_matrices();
+  }
+
+  /**
+   * @brief splits the bezier at time t
+   *
+   * Both halves are exact, with coefficient matrices of their own. Their
+   * lengths are integrated on this curve over the same intervals and to the
+   * same tolerance as the halves would use themselves (see part_length()),
+   * so they match what the halves compute on their own. They don't add up
+   * exactly to this curve's length, which was integrated over other
+   * intervals. The halves' own tables are only built once used.
+   *
+   * @param t time to split at
+   * @return the part over [0, t] and the part over [t, 1]
+   */
+  std::pair<Derived, Derived> split(Float t) {
+    const auto [left, right] = geometry::split_controls(getControlPoints(), t);
+    return {part(left, part_length(0, t)), part(right, part_length(t, 1))};
+  }
+
+  /**
+   * @brief part of the bezier between times t0 and t1
+   *
+   * @param t0 start time, the part is reversed if t0 > t1
+   * @param t1 end time
+   */
+  Derived trim(Float t0, Float t1) {
+    return part(geometry::subcurve_controls(getControlPoints(), t0, t1),
+                part_length(t0, t1));
+  }
+
+  /**
+   * @brief part of the bezier between two distances along it
+   *
+   * @param s0 distance at which the part starts, clamped to the curve
+   * @param s1 distance at which the part ends, clamped to the curve
+   */
+  Derived trim_by_s(LengthType s0, LengthType s1) {
+    const LengthType total = this->total_distance();
+    s0 = std::clamp(s0, LengthType(0.0), total);
+    s1 = std::clamp(s1, LengthType(0.0), total);
+    const Float t0 = t_by_s(s0), t1 = t_by_s(s1);
+    return part(geometry::subcurve_controls(getControlPoints(), t0, t1),
+                part_length(t0, t1));
+  }
+
+  std::array<Point, N> getControlPoints() const {
+    std::array<Point, N> controls;
+    controls[0] = endpoints[0];
+    std::copy(m_controls.begin(), m_controls.end(), controls.begin() + 1);
+    controls[N - 1] = endpoints[1];
+    return controls;
+  }
+};
+
+} // namespace geometry
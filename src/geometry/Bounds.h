@@ -0,0 +1,68 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <limits>
+
+namespace geometry {
+
+/**
+ * @brief axis aligned bounding box
+ *
+ * Stored as raw scalars in internal units (meters) like CurveSamples, since
+ * boxes are mostly used in tight rejection loops. A default constructed box
+ * is empty and grows with expand().
+ */
+template <std::floating_point Float> struct BasicBox {
+  Float min_x = std::numeric_limits<Float>::infinity();
+  Float min_y = std::numeric_limits<Float>::infinity();
+  Float max_x = -std::numeric_limits<Float>::infinity();
+  Float max_y = -std::numeric_limits<Float>::infinity();
+
+  bool empty() const { return min_x > max_x || min_y > max_y; }
+
+  void expand(Float x, Float y) {
+    min_x = std::min(min_x, x);
+    min_y = std::min(min_y, y);
+    max_x = std::max(max_x, x);
+    max_y = std::max(max_y, y);
+  }
+
+  void expand(const BasicBox &other) {
+    min_x = std::min(min_x, other.min_x);
+    min_y = std::min(min_y, other.min_y);
+    max_x = std::max(max_x, other.max_x);
+    max_y = std::max(max_y, other.max_y);
+  }
+
+  // grows the box by margin on every side
+  BasicBox padded(Float margin) const {
+    return {min_x - margin, min_y - margin, max_x + margin, max_y + margin};
+  }
+
+  bool intersects(const BasicBox &other) const {
+    return min_x <= other.max_x && other.min_x <= max_x &&
+           min_y <= other.max_y && other.min_y <= max_y;
+  }
+
+  bool contains(Float x, Float y) const {
+    return x >= min_x && x <= max_x && y >= min_y && y <= max_y;
+  }
+
+  // squared distance from a point to the box, zero inside it
+  Float distance2(Float x, Float y) const {
+    const Float dx = std::max({min_x - x, Float(0), x - max_x});
+    const Float dy = std::max({min_y - y, Float(0), y - max_y});
+    return dx * dx + dy * dy;
+  }
+
+  Float center_x() const { return (min_x + max_x) / 2; }
+  Float center_y() const { return (min_y + max_y) / 2; }
+  Float width() const { return max_x - min_x; }
+  Float height() const { return max_y - min_y; }
+};
+
+using Box = BasicBox<float>;
+using DBox = BasicBox<double>;
+
+} // namespace geometry
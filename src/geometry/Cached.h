@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+namespace geometry {
+
+/**
+ * @brief value derived from a curve, recomputed when the curve changes
+ *
+ * Curves bump their version whenever their control points change. The cache
+ * remembers the version its value was computed for and only calls the
+ * compute function again once the version differs.
+ *
+ * @tparam T type of the cached value
+ */
+template <typename T> class VersionedCache {
+public:
+  /**
+   * @brief returns the cached value, recomputing it if it is stale
+   *
+   * @param version current version of the curve
+   * @param compute called with no arguments to produce a fresh value
+   */
+  template <typename F> const T &get(uint64_t version, F &&compute) {
+    if (!m_valid || m_version != version) {
+      m_value = compute();
+      m_version = version;
+      m_valid = true;
+    }
+    return m_value;
+  }
+
+  // stores a value that is already known for a version, e.g. derived from
+  // another curve
+  void set(uint64_t version, T value) {
+    m_value = std::move(value);
+    m_version = version;
+    m_valid = true;
+  }
+
+  // whether get() would return the value without recomputing it
+  bool valid(uint64_t version) const { return m_valid && m_version == version; }
+
+  // last computed value, whether or not it is still valid
+  const T &value() const { return m_value; }
+
+  void invalidate() { m_valid = false; }
+
+private:
+  T m_value{};
+  uint64_t m_version = 0;
+  bool m_valid = false;
+};
+
+} // namespace geometry
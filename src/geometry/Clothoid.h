@@ -0,0 +1,311 @@
+#pragma once
+
+#include "Curve.h"
+#include "Fresnel.h"
+#include "Polynomial.h"
+#include "units/Pose.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <span>
+
+namespace geometry {
+
+/**
+ * @brief clothoid (Euler spiral), a curve whose curvature changes linearly
+ * with distance
+ *
+ * The smoothest way into and out of an arc, and easier for path followers
+ * to track than a bezier of the same shape. Time is proportional to the
+ * distance travelled, so s() and t_by_s() are exact and need no
+ * integration.
+ *
+ * Positions come from the Fresnel integrals. Far from the inflection point
+ * of the spiral they are taken from the auxiliary functions instead, paired
+ * with the exact heading, so nearly circular clothoids don't lose digits to
+ * huge phase angles. Curves with (next to) constant curvature are evaluated
+ * as arcs. Everything is computed in double, whatever the scalar type.
+ *
+ * @tparam Float scalar type, float or double
+ */
+template <std::floating_point Float>
+class BasicClothoid final : public BasicCurve<Float> {
+public:
+  using Base = BasicCurve<Float>;
+  using typename Base::Box;
+  using typename Base::CurvatureType;
+  using typename Base::LengthType;
+  using typename Base::PointType;
+  using typename Base::Samples;
+
+  using Base::bounds;
+  using Base::endpoints;
+
+  /**
+   * @param start pose the clothoid starts at
+   * @param start_curvature curvature at the start, positive turns left
+   * @param end_curvature curvature at the end
+   * @param length length of the clothoid
+   */
+  BasicClothoid(const Pose &start, Curvature start_curvature,
+                Curvature end_curvature, Length length)
+      : Base(Point(start.x, start.y), Point(start.x, start.y)),
+        m_x0(start.x.internal()), m_y0(start.y.internal()),
+        m_theta0(start.orientation.internal()),
+        m_k0(start_curvature.internal()),
+        m_length(std::max(length.internal(), 0.0)) {
+    m_dk = m_length > 0
+               ? (end_curvature.internal() - start_curvature.internal()) /
+                     m_length
+               : 0;
+
+    // below this the spiral is never more than 1e-12 rad off an arc
+    m_fresnel = std::abs(m_dk) * m_length * m_length > 1e-12;
+    if (m_fresnel) {
+      m_mirror = m_dk < 0 ? -1 : 1;
+      const double dk = std::abs(m_dk), k0 = m_mirror * m_k0;
+      m_scale = std::sqrt(dk / std::numbers::pi);
+      m_u0 = k0 / (m_scale * std::numbers::pi);
+      const double theta_c = m_mirror * m_theta0 - k0 * k0 / (2 * dk);
+      m_cos_c = std::cos(theta_c);
+      m_sin_c = std::sin(theta_c);
+      double a, b;
+      parts(m_u0, a, b);
+      m_start = term(m_u0, m_mirror * m_theta0, a, b);
+    }
+
+    const std::array<double, 2> end = position(m_length);
+    endpoints[1] = Point(end[0] * m, end[1] * m);
+  }
+
+  Curvature startCurvature() const { return Curvature(m_k0); }
+
+  Curvature endCurvature() const { return Curvature(m_k0 + m_dk * m_length); }
+
+  // way the curve heads at time t, in radians
+  Float heading(Float t) const { return Float(theta(distance(t))); }
+
+  PointType f(Float t) override {
+    const std::array<double, 2> p = position(distance(t));
+    return point(p[0], p[1]);
+  }
+
+  PointType df(Float t) override {
+    const double angle = theta(distance(t));
+    return point(m_length * std::cos(angle), m_length * std::sin(angle));
+  }
+
+  PointType ddf(Float t) override {
+    const double s = distance(t);
+    const double angle = theta(s);
+    const double scale = m_length * m_length * curvature(s);
+    return point(-scale * std::sin(angle), scale * std::cos(angle));
+  }
+
+  PointType dddf(Float t) override {
+    const double s = distance(t);
+    const double angle = theta(s), k = curvature(s);
+    const double cube = m_length * m_length * m_length;
+    const double cos = std::cos(angle), sin = std::sin(angle);
+    return point(cube * (-m_dk * sin - k * k * cos),
+                 cube * (m_dk * cos - k * k * sin));
+  }
+
+  /**
+   * @brief sample clothoid at every time in t
+   *
+   * The Fresnel integrals of each chunk of samples go through one
+   * vectorized pass, only the phase terms are computed per sample.
+   *
+   * @param t times at which to sample
+   * @param out buffer resized to t.size() and filled with positions
+   */
+  void f_batch(std::span<const Float> t, Samples &out) override {
+    if (!m_fresnel) {
+      Base::f_batch(t, out);
+      return;
+    }
+
+    out.resize(t.size());
+    constexpr size_t chunk = 64;
+    std::array<double, chunk> u, a, b;
+    for (size_t first = 0; first < t.size(); first += chunk) {
+      const size_t n = std::min(chunk, t.size() - first);
+      for (size_t i = 0; i < n; i++) {
+        u[i] = m_u0 + m_scale * distance(t[first + i]);
+      }
+      detail::fresnel_parts_batch(std::span<const double>(u.data(), n),
+                                  a.data(), b.data());
+      for (size_t i = 0; i < n; i++) {
+        const double s = distance(t[first + i]);
+        const std::array<double, 2> p =
+            from_terms(term(u[i], m_mirror * theta(s), a[i], b[i]));
+        out.x[first + i] = Float(p[0]);
+        out.y[first + i] = Float(p[1]);
+      }
+    }
+  }
+
+  CurvatureType c(Float t) override {
+    return CurvatureType(Float(curvature(distance(t))));
+  }
+
+  CurvatureType c(Float t, PointType) override { return c(t); }
+
+  LengthType s(Float t) override { return LengthType(Float(t * m_length)); }
+
+  LengthType s(Float t0, Float t1) override {
+    return LengthType(Float((t1 - t0) * m_length));
+  }
+
+  Float t_by_s(LengthType target, Float) override { return t_by_s(target); }
+
+  Float t_by_s(LengthType target) override {
+    if (m_length <= 0)
+      return 0;
+    return std::clamp(Float(target.internal() / m_length), Float(0),
+                      Float(1));
+  }
+
+  /**
+   * @brief exact axis aligned bounds of the clothoid between times t0 and t1
+   *
+   * The clothoid is extreme in x where it heads straight up or down and in y
+   * where it heads straight left or right. The heading is quadratic in
+   * distance, so those points are roots of quadratics.
+   *
+   * @param t0 start time
+   * @param t1 end time
+   * @return box in internal units
+   */
+  Box bounds(Float t0, Float t1) override {
+    Box box;
+    const double lo = distance(std::min(t0, t1));
+    const double hi = distance(std::max(t0, t1));
+    for (double s : {lo, hi}) {
+      const std::array<double, 2> p = position(s);
+      box.expand(Float(p[0]), Float(p[1]));
+    }
+
+    // range of the heading, which is extreme at the ends or where the
+    // curvature crosses zero
+    double min_theta = std::min(theta(lo), theta(hi));
+    double max_theta = std::max(theta(lo), theta(hi));
+    if (m_dk != 0) {
+      const double inflection = -m_k0 / m_dk;
+      if (inflection > lo && inflection < hi) {
+        min_theta = std::min(min_theta, theta(inflection));
+        max_theta = std::max(max_theta, theta(inflection));
+      }
+    }
+
+    constexpr double quarter = std::numbers::pi / 2;
+    std::array<double, 2> roots;
+    for (double j = std::ceil(min_theta / quarter);
+         j <= std::floor(max_theta / quarter); j++) {
+      const size_t count = geometry::solve_quadratic(
+          m_dk / 2, m_k0, m_theta0 - j * quarter, roots);
+      for (size_t i = 0; i < count; i++) {
+        if (roots[i] > lo && roots[i] < hi) {
+          const std::array<double, 2> p = position(roots[i]);
+          box.expand(Float(p[0]), Float(p[1]));
+        }
+      }
+    }
+    return box;
+  }
+
+private:
+  double m_x0, m_y0, m_theta0;
+  // curvature at the start and its change per meter
+  double m_k0, m_dk = 0;
+  double m_length;
+
+  // Fresnel form of the clothoid, mirrored so that its curvature increases:
+  // the heading is theta_c + pi / 2 u^2 with u = m_u0 + m_scale s
+  bool m_fresnel = false;
+  double m_mirror = 1;
+  double m_scale = 0, m_u0 = 0;
+  double m_cos_c = 1, m_sin_c = 0;
+  // term() at the start of the clothoid
+  std::array<double, 2> m_start{};
+
+  static PointType point(double x, double y) {
+    return PointType(LengthType(Float(x) * m), LengthType(Float(y) * m));
+  }
+
+  double distance(Float t) const {
+    return std::clamp(double(t), 0.0, 1.0) * m_length;
+  }
+
+  double theta(double s) const {
+    return m_theta0 + (m_k0 + m_dk / 2 * s) * s;
+  }
+
+  double curvature(double s) const { return m_k0 + m_dk * s; }
+
+  // one element of detail::fresnel_parts_batch
+  static void parts(double u, double &a, double &b) {
+    if (std::abs(u) <= detail::fresnel_switch)
+      detail::fresnel_series(u, a, b);
+    else
+      detail::fresnel_auxiliary_fit().evaluate(std::abs(u), a, b);
+  }
+
+  /**
+   * @brief integral of the mirrored unit tangent from the inflection point,
+   * up to a constant, times m_scale
+   *
+   * @param u Fresnel argument at the distance
+   * @param mirrored_theta mirrored heading at the distance
+   * @param a C(u), or f(|u|) past detail::fresnel_switch
+   * @param b S(u), or g(|u|) past detail::fresnel_switch
+   */
+  std::array<double, 2> term(double u, double mirrored_theta, double a,
+                             double b) const {
+    if (std::abs(u) <= detail::fresnel_switch)
+      return {m_cos_c * a - m_sin_c * b, m_sin_c * a + m_cos_c * b};
+
+    // e^(i theta_c) (C + i S) = +-((1 + i) / 2 e^(i theta_c) - (g + i f)
+    // e^(i theta)), so the huge phase of a nearly circular clothoid only
+    // appears in a constant that cancels against the start
+    const double sign = u < 0 ? -1 : 1;
+    const double cos = std::cos(mirrored_theta), sin = std::sin(mirrored_theta);
+    return {sign * ((m_cos_c - m_sin_c) / 2 - (b * cos - a * sin)),
+            sign * ((m_cos_c + m_sin_c) / 2 - (b * sin + a * cos))};
+  }
+
+  // position from the term() at a distance
+  std::array<double, 2> from_terms(const std::array<double, 2> &end) const {
+    const double dx = (end[0] - m_start[0]) / m_scale;
+    const double dy = (end[1] - m_start[1]) / m_scale;
+    return {m_x0 + dx, m_y0 + m_mirror * dy};
+  }
+
+  std::array<double, 2> position(double s) const {
+    if (!m_fresnel) {
+      // chord of an arc, s sinc(k s / 2) long and halfway through the turn
+      const double half = m_k0 * s / 2;
+      const double chord =
+          std::abs(half) < 1e-4 ? s * (1 - half * half / 6)
+                                : s * std::sin(half) / half;
+      const double mid = m_theta0 + half;
+      return {m_x0 + chord * std::cos(mid), m_y0 + chord * std::sin(mid)};
+    }
+
+    const double u = m_u0 + m_scale * s;
+    double a, b;
+    parts(u, a, b);
+    return from_terms(term(u, m_mirror * theta(s), a, b));
+  }
+
+  LengthType compute_total_distance() override {
+    return LengthType(Float(m_length));
+  }
+};
+
+using Clothoid = BasicClothoid<float>;
+using DClothoid = BasicClothoid<double>;
+
+} // namespace geometry
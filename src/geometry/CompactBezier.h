@@ -0,0 +1,199 @@
+#pragma once
+
+#include "Curve.h"
+#include "Polynomial.h"
+#include "Quadrature.h"
+#include "StaticCurve.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace geometry {
+
+/**
+ * @brief cubic bezier reduced to its control points
+ *
+ * A CubicBezier carries a vtable, coefficient matrices, an arc length table
+ * and the caches shared with the GUI, which makes it hundreds of bytes. This
+ * one only stores the four control points as raw scalars (32 bytes for
+ * float), so large imported logs can live in one contiguous array and stay
+ * in cache. It is not a Curve, but satisfies StaticCurve, so the templated
+ * algorithms (flatten, project, find_curvature_extrema, ...) accept it.
+ *
+ * Arc length is integrated on demand with the adaptive Gauss-Kronrod rule,
+ * to the default integration tolerance, instead of being tabulated.
+ */
+template <std::floating_point Float> class BasicCompactBezier {
+public:
+  using Scalar = Float;
+  using LengthType = typename BasicCurve<Float>::LengthType;
+  using CurvatureType = typename BasicCurve<Float>::CurvatureType;
+  using PointType = typename BasicCurve<Float>::PointType;
+  using Box = typename BasicCurve<Float>::Box;
+
+  BasicCompactBezier() = default;
+
+  BasicCompactBezier(std::array<Point, 4> controls) {
+    for (size_t i = 0; i < 4; i++) {
+      m_x[i] = controls[i].x.internal();
+      m_y[i] = controls[i].y.internal();
+    }
+  }
+
+  std::array<Point, 4> getControlPoints() const {
+    std::array<Point, 4> controls;
+    for (size_t i = 0; i < 4; i++) {
+      controls[i] = Point(m_x[i] * m, m_y[i] * m);
+    }
+    return controls;
+  }
+
+  PointType f(Float t) const {
+    const Float s = 1 - t;
+    const std::array<Float, 4> b{s * s * s, 3 * s * s * t, 3 * s * t * t,
+                                 t * t * t};
+    return point(combine(m_x, b), combine(m_y, b));
+  }
+
+  PointType df(Float t) const {
+    const Float s = 1 - t;
+    const std::array<Float, 3> b{3 * s * s, 6 * s * t, 3 * t * t};
+    return point(combine(differences(m_x), b), combine(differences(m_y), b));
+  }
+
+  PointType ddf(Float t) const {
+    const std::array<Float, 2> b{6 * (1 - t), 6 * t};
+    return point(combine(differences(differences(m_x)), b),
+                 combine(differences(differences(m_y)), b));
+  }
+
+  // third derivative of a cubic is constant
+  PointType dddf(Float) const {
+    return point(6 * (m_x[3] - 3 * m_x[2] + 3 * m_x[1] - m_x[0]),
+                 6 * (m_y[3] - 3 * m_y[2] + 3 * m_y[1] - m_y[0]));
+  }
+
+  // curvature at t (Sprunk 12)
+  CurvatureType c(Float t) const { return c(t, df(t)); }
+
+  // curvature at t (Sprunk 12)
+  CurvatureType c(Float t, PointType df_t) const {
+    const Float dx = df_t.x.internal(), dy = df_t.y.internal();
+    const Float speed = std::hypot(dx, dy);
+
+    // avoids dividing by zero, like CubicBezier
+    if (speed * speed * speed < Float(1e-6))
+      return CurvatureType(0.0);
+
+    const PointType second_derivative = ddf(t);
+    return CurvatureType((dx * second_derivative.y.internal() -
+                          dy * second_derivative.x.internal()) /
+                         (speed * speed * speed));
+  }
+
+  LengthType s(Float t) const { return s(0, t); }
+
+  // distance travelled between times t0 and t1, negative if t1 < t0
+  LengthType s(Float t0, Float t1) const {
+    size_t evaluations = 0;
+    auto speed = [this](Float t) {
+      const PointType d = df(t);
+      return std::hypot(d.x.internal(), d.y.internal());
+    };
+    const Integration integration;
+    const Float tolerance = integration.tolerance * std::abs(t1 - t0);
+    return LengthType(adaptive_gauss_kronrod(
+        speed, t0, t1, tolerance, integration.max_depth, evaluations));
+  }
+
+  // time by distance, Newton's method on s(t) - target
+  Float t_by_s(LengthType target, Float t_guess) const {
+    const LengthType tol = LengthType(in * 1e-2);
+    constexpr int max_iter = 20;
+    for (int i = 0; i < max_iter; i++) {
+      const LengthType error = s(t_guess) - target;
+      if (units::abs(error) < tol)
+        break;
+
+      const PointType d = df(t_guess);
+      const Float speed = std::hypot(d.x.internal(), d.y.internal());
+      if (speed <= Float(1e-6))
+        break;
+      t_guess = std::clamp(t_guess - error.internal() / speed, Float(0),
+                           Float(1));
+    }
+    return t_guess;
+  }
+
+  Float t_by_s(LengthType target) const { return t_by_s(target, 0.5); }
+
+  /**
+   * @brief exact axis aligned bounds of the bezier between times t0 and t1
+   *
+   * @param t0 start time
+   * @param t1 end time
+   * @return box in internal units
+   */
+  Box bounds(Float t0 = 0, Float t1 = 1) const {
+    Box box;
+    for (Float t : {t0, t1}) {
+      const PointType p = f(t);
+      box.expand(p.x.internal(), p.y.internal());
+    }
+
+    const Float lo = std::min(t0, t1);
+    const Float hi = std::max(t0, t1);
+    std::array<Float, 2> roots;
+    for (const std::array<Float, 4> *coordinate : {&m_x, &m_y}) {
+      // derivative of the coordinate in the power basis, up to a factor of 3
+      const std::array<Float, 3> d = differences(*coordinate);
+      const size_t count = geometry::solve_quadratic(
+          d[0] - 2 * d[1] + d[2], 2 * (d[1] - d[0]), d[0], roots);
+      for (size_t i = 0; i < count; i++) {
+        if (roots[i] > lo && roots[i] < hi) {
+          const PointType p = f(roots[i]);
+          box.expand(p.x.internal(), p.y.internal());
+        }
+      }
+    }
+    return box;
+  }
+
+private:
+  // control points, in meters
+  std::array<Float, 4> m_x{};
+  std::array<Float, 4> m_y{};
+
+  static PointType point(Float x, Float y) {
+    return PointType(LengthType(x * m), LengthType(y * m));
+  }
+
+  // forward differences of bezier coefficients, the controls of the
+  // derivative up to a constant factor
+  template <size_t N>
+  static std::array<Float, N - 1> differences(const std::array<Float, N> &c) {
+    std::array<Float, N - 1> result;
+    for (size_t i = 0; i + 1 < N; i++) {
+      result[i] = c[i + 1] - c[i];
+    }
+    return result;
+  }
+
+  template <size_t N>
+  static Float combine(const std::array<Float, N> &c,
+                       const std::array<Float, N> &basis) {
+    Float sum = 0;
+    for (size_t i = 0; i < N; i++) {
+      sum += c[i] * basis[i];
+    }
+    return sum;
+  }
+};
+
+using CompactBezier = BasicCompactBezier<float>;
+using DCompactBezier = BasicCompactBezier<double>;
+
+static_assert(StaticCurve<CompactBezier>);
+static_assert(sizeof(CompactBezier) == 8 * sizeof(float));
+
+} // namespace geometry
@@ -0,0 +1,225 @@
+#pragma once
+
+#include "CurveAnalysis.h"
+#include "SplinePath.h"
+#include "StaticCurve.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace geometry {
+
+namespace detail {
+
+/**
+ * @brief finds a root of f in [a, b], given f(a) and f(b) of opposite sign
+ *
+ * Regula falsi with the Illinois modification, which keeps the bracket
+ * shrinking from both sides and converges superlinearly.
+ */
+template <std::floating_point Float, typename F>
+inline Float find_root(F &&f, Float a, Float fa, Float b, Float fb) {
+  constexpr int max_iter = 32;
+  const Float tol = std::numeric_limits<Float>::epsilon() * 4;
+
+  int side = 0;
+  Float c = a;
+  for (int i = 0; i < max_iter && b - a > tol; i++) {
+    c = (a * fb - b * fa) / (fb - fa);
+    if (!(c > a && c < b))
+      c = (a + b) / 2;
+    const Float fc = f(c);
+    if (fc == 0)
+      return c;
+
+    if ((fc > 0) == (fb > 0)) {
+      b = c;
+      fb = fc;
+      // the same end moved twice, halve the other end's weight
+      if (side == -1)
+        fa /= 2;
+      side = -1;
+    } else {
+      a = c;
+      fa = fc;
+      if (side == 1)
+        fb /= 2;
+      side = 1;
+    }
+  }
+  return c;
+}
+
+template <StaticCurve C> struct CurvatureScanner {
+  using Float = typename C::Scalar;
+
+  // signs of the curvature and speed derivatives at a time
+  struct Sample {
+    Float t;
+    // numerator of dk/dt
+    Float rate;
+    // f' . f'', half the derivative of the squared speed
+    Float dot;
+  };
+
+  C &curve;
+  BasicCurvatureExtrema<Float> &out;
+
+  // first time of the run of zero rates the scan is in, and the sign of the
+  // rate before it. Only a run the sign changes across is an extremum
+  Float zero_t = 0;
+  Float sign_before = 0;
+
+  // intervals with a speed minimum are rescanned up to this many times more
+  // finely, near cusps the curvature spikes over a tiny range of t
+  static constexpr int max_depth = 3;
+  static constexpr size_t refine_divisions = 8;
+
+  // with k = (f' x f'') / |f'|^3, dk/dt is
+  // ((f' x f''') |f'|^2 - 3 (f' x f'') (f' . f'')) / |f'|^5, so the numerator
+  // alone has the same sign and roots without dividing by the speed
+  Sample sample(Float t) {
+    const auto d = curve.df(t);
+    const auto dd = curve.ddf(t);
+    const auto ddd = curve.dddf(t);
+
+    const Float dx = d.x.internal(), dy = d.y.internal();
+    const Float ddx = dd.x.internal(), ddy = dd.y.internal();
+    const Float dddx = ddd.x.internal(), dddy = ddd.y.internal();
+
+    const Float speed2 = dx * dx + dy * dy;
+    const Float cross = dx * ddy - dy * ddx;
+    const Float dot = dx * ddx + dy * ddy;
+    const Float rate = (dx * dddy - dy * dddx) * speed2 - 3 * cross * dot;
+
+    // rounding error bound of rate, anything within it is constant
+    // curvature (a straight line or collinear controls), not a sign
+    const Float bound = (std::abs(dx * dddy) + std::abs(dy * dddx)) * speed2 +
+                        3 * (std::abs(dx * ddy) + std::abs(dy * ddx)) *
+                            (std::abs(dx * ddx) + std::abs(dy * ddy));
+    const Float noise = 16 * std::numeric_limits<Float>::epsilon() * bound;
+    return {t, std::abs(rate) <= noise ? Float(0) : rate, dot};
+  }
+
+  // unlike Curve::c, which returns 0 where the curve nearly stops, near
+  // cusps report their (huge) curvature so they can't pass as straight
+  Float curvature(Float t) {
+    const auto d = curve.df(t);
+    const auto dd = curve.ddf(t);
+    const Float dx = d.x.internal(), dy = d.y.internal();
+    const Float speed2 = dx * dx + dy * dy;
+    if (speed2 == 0)
+      return std::numeric_limits<Float>::infinity();
+    const Float cross = dx * dd.y.internal() - dy * dd.x.internal();
+    return cross / (speed2 * std::sqrt(speed2));
+  }
+
+  void add(Float t) {
+    const Float curvature = this->curvature(t);
+    out.extrema.push_back({t, curvature});
+    if (std::abs(curvature) > std::abs(out.maximum.curvature))
+      out.maximum = {t, curvature};
+  }
+
+  // adds the extrema after a.t up to b.t, splitting [a, b] into divisions
+  void scan(Sample a, Sample b, int depth, size_t divisions) {
+    Sample prev = a;
+    for (size_t i = 1; i <= divisions; i++) {
+      const Sample next =
+          i == divisions ? b : sample(a.t + (b.t - a.t) * i / divisions);
+      interval(prev, next, depth);
+      prev = next;
+    }
+  }
+
+  void interval(Sample a, Sample b, int depth) {
+    // the speed has a minimum inside, which may hide a close pair of roots
+    if (depth < max_depth && a.dot < 0 && b.dot > 0) {
+      scan(a, b, depth + 1, refine_divisions);
+      return;
+    }
+
+    if ((a.rate < 0 && b.rate > 0) || (a.rate > 0 && b.rate < 0)) {
+      add(find_root([this](Float t) { return sample(t).rate; }, a.t, a.rate,
+                    b.t, b.rate));
+    } else if (b.rate == 0 && a.rate != 0) {
+      zero_t = b.t;
+      sign_before = a.rate;
+    } else if (a.rate == 0 && b.rate != 0) {
+      // leaving a run of zeros, which is only an extremum if the sign
+      // flipped across it
+      if ((sign_before < 0 && b.rate > 0) || (sign_before > 0 && b.rate < 0))
+        add(zero_t);
+      sign_before = 0;
+    }
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief finds the local extrema of a curve's signed curvature
+ *
+ * The derivative of curvature is sampled to bracket its sign changes, and
+ * each bracket is narrowed to the root with a few function evaluations.
+ * Intervals containing a speed minimum are sampled more finely, since a near
+ * cusp squeezes a sharp curvature peak between two samples. Both ends of the
+ * curve are included, since the largest curvature often lies on one of them.
+ *
+ * @param curve curve to analyze
+ * @return extrema ordered by time, and the one of largest magnitude
+ */
+template <StaticCurve C>
+BasicCurvatureExtrema<typename C::Scalar> find_curvature_extrema(C &curve) {
+  using Float = typename C::Scalar;
+
+  // a cubic's curvature has at most 5 interior extrema, so a handful of
+  // samples per extremum is enough to bracket them separately
+  constexpr size_t samples = 32;
+
+  BasicCurvatureExtrema<Float> result;
+  detail::CurvatureScanner<C> scanner{curve, result};
+  result.maximum = {0, scanner.curvature(0)};
+  result.extrema.push_back(result.maximum);
+  scanner.scan(scanner.sample(0), scanner.sample(1), 0, samples);
+  scanner.add(1);
+  return result;
+}
+
+/**
+ * @brief returns the curve's cached curvature extrema, finding them if needed
+ *
+ * The result is kept until the control points change, so checking every
+ * segment of a path after each edit only analyzes the edited ones.
+ *
+ * @param curve curve to analyze
+ */
+template <std::floating_point Float>
+const BasicCurvatureExtrema<Float> &
+curvature_extrema(BasicCurve<Float> &curve) {
+  return curve.curvatureCache().get(
+      curve.version(), [&curve] { return find_curvature_extrema(curve); });
+}
+
+/**
+ * @brief finds the segments of a path that turn tighter than a limit
+ *
+ * @param path path to check
+ * @param limit largest curvature magnitude the drivetrain can follow
+ * @return indices of the offending segments, in order
+ */
+template <std::floating_point Float>
+std::vector<size_t>
+segments_exceeding(BasicSplinePath<Float> &path,
+                   typename BasicCurve<Float>::CurvatureType limit) {
+  std::vector<size_t> result;
+  for (size_t i = 0; i < path.size(); i++) {
+    const Float maximum =
+        std::abs(curvature_extrema(path.segment(i)).maximum.curvature);
+    if (maximum > limit.internal())
+      result.push_back(i);
+  }
+  return result;
+}
+
+} // namespace geometry
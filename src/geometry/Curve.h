@@ -1,20 +1,61 @@
 #pragma once
 
 #include "../utils.h"
+#include "Bounds.h"
+#include "Cached.h"
+#include "CurveAnalysis.h"
+#include "Quadrature.h"
+#include "Samples.h"
+#include <algorithm>
 #include <array>
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <vector>
 
-class Curve {
+/**
+ * @brief base class of all curves
+ *
+ * Curves are templated on the scalar type used for times and for their
+ * internal computations, so offline trajectory generation can run in double
+ * precision while realtime previews use float. Control points are authored
+ * in the GUI's double based Point regardless of the scalar type.
+ *
+ * @tparam Float scalar type, float or double
+ */
+template <std::floating_point Float> class BasicCurve {
 public:
-  FLength total_distance;
+  using Scalar = Float;
+  // FLength/FCurvature for float, Length/Curvature for double
+  using LengthType = Named<Length::Other<Float>>;
+  using CurvatureType = Named<Curvature::Other<Float>>;
+  using PointType = units::Vector2D<LengthType>;
+  using Samples = geometry::BasicCurveSamples<Float>;
+  using Polyline = geometry::BasicPolyline<Float>;
+  using Box = geometry::BasicBox<Float>;
+  using CurvatureExtrema = geometry::BasicCurvatureExtrema<Float>;
+  using InverseArcLength = geometry::BasicInverseArcLength<Float>;
+
   std::array<Point, 2> endpoints;
 
+  /**
+   * @brief length of the whole curve
+   *
+   * Computed on the first call after the curve changed, so dragging a
+   * control point doesn't integrate the curve on every mouse move.
+   */
+  LengthType total_distance() {
+    return m_length_cache.get(m_version,
+                              [this] { return compute_total_distance(); });
+  }
+
   /**
    * @brief sample point of curve at sample time t
    *
    * @param t time at which to sample
    * @return point of curve at time t
    */
-  virtual Point f(float t) = 0;
+  virtual PointType f(Float t) = 0;
 
   /**
    * @brief sample first gradient(derivative) of curve at sample time t
@@ -22,7 +63,7 @@ public:
    * @param t time at which to sample
    * @return second gradient(derivative) of curve at time t
    */
-  virtual Point df(float t) = 0;
+  virtual PointType df(Float t) = 0;
 
   /**
    * @brief sample second gradient(derivative) of curve at sample time t
@@ -30,31 +71,246 @@ public:
    * @param t time at which to sample
    * @return second gradient(derivative) of curve at time t
    */
-  virtual Point ddf(float t) = 0;
+  virtual PointType ddf(Float t) = 0;
+
+  /**
+   * @brief sample third gradient(derivative) of curve at sample time t
+   *
+   * The default implementation differentiates ddf() numerically. Curves with
+   * a closed form override it.
+   *
+   * @param t time at which to sample
+   * @return third gradient(derivative) of curve at time t
+   */
+  virtual PointType dddf(Float t) {
+    constexpr Float h = Float(1e-3);
+    const Float t0 = std::max(t - h, Float(0));
+    const Float t1 = std::min(t + h, Float(1));
+    return (ddf(t1) - ddf(t0)) / (t1 - t0);
+  }
+
+  /**
+   * @brief sample curve at every time in t
+   *
+   * Results are written to out in internal units. The default implementation
+   * calls f() per sample; polynomial curves override it with a vectorized
+   * evaluation.
+   *
+   * @param t times at which to sample
+   * @param out buffer resized to t.size() and filled with the samples
+   */
+  virtual void f_batch(std::span<const Float> t, Samples &out) {
+    out.resize(t.size());
+    for (size_t i = 0; i < t.size(); i++) {
+      PointType p = f(t[i]);
+      out.x[i] = p.x.internal();
+      out.y[i] = p.y.internal();
+    }
+  }
+
+  /**
+   * @brief sample first derivative of curve at every time in t
+   *
+   * @param t times at which to sample
+   * @param out buffer resized to t.size() and filled with the samples
+   */
+  virtual void df_batch(std::span<const Float> t, Samples &out) {
+    out.resize(t.size());
+    for (size_t i = 0; i < t.size(); i++) {
+      PointType p = df(t[i]);
+      out.x[i] = p.x.internal();
+      out.y[i] = p.y.internal();
+    }
+  }
+
+  /**
+   * @brief sample second derivative of curve at every time in t
+   *
+   * @param t times at which to sample
+   * @param out buffer resized to t.size() and filled with the samples
+   */
+  virtual void ddf_batch(std::span<const Float> t, Samples &out) {
+    out.resize(t.size());
+    for (size_t i = 0; i < t.size(); i++) {
+      PointType p = ddf(t[i]);
+      out.x[i] = p.x.internal();
+      out.y[i] = p.y.internal();
+    }
+  }
+
+  /**
+   * @brief sample curve at n uniformly spaced times from t0 to t1
+   *
+   * Fills the same buffer as f_batch. The default implementation builds the
+   * times and calls f_batch; polynomial curves override it with forward
+   * differencing.
+   *
+   * @param t0 first time
+   * @param t1 last time, included
+   * @param n number of samples
+   * @param out buffer resized to n and filled with the samples
+   */
+  virtual void f_uniform(Float t0, Float t1, size_t n, Samples &out) {
+    f_batch(uniform_times(t0, t1, n), out);
+  }
+
+  /**
+   * @brief sample first derivative of curve at n uniformly spaced times
+   *
+   * @param t0 first time
+   * @param t1 last time, included
+   * @param n number of samples
+   * @param out buffer resized to n and filled with the samples
+   */
+  virtual void df_uniform(Float t0, Float t1, size_t n, Samples &out) {
+    df_batch(uniform_times(t0, t1, n), out);
+  }
+
+  // step between n uniformly spaced times from t0 to t1
+  static Float uniform_step(Float t0, Float t1, size_t n) {
+    return n > 1 ? (t1 - t0) / (n - 1) : 0;
+  }
 
   // curvature at point c
-  virtual FCurvature c(float t) = 0;
+  virtual CurvatureType c(Float t) = 0;
 
   // curvature at point c. allows using an already computed value of df
-  virtual FCurvature c(float t, Point df) = 0;
+  virtual CurvatureType c(Float t, PointType df) = 0;
 
   // gets distance at time
-  virtual FLength s(float t) = 0;
+  virtual LengthType s(Float t) = 0;
+
+  // gets distance travelled between times t0 and t1, negative if t1 < t0.
+  // curves should override this to only integrate over [t0, t1]
+  virtual LengthType s(Float t0, Float t1) { return s(t1) - s(t0); }
 
   // gets time from arc length
   // allows passing in an initial guess of t,
   // useful if a t is known for which s(t) is close to the target
-  virtual float t_by_s(FLength target, float t_guess) = 0;
+  virtual Float t_by_s(LengthType target, Float t_guess) = 0;
 
   // gets time by distance
-  virtual float t_by_s(FLength target) = 0;
+  virtual Float t_by_s(LengthType target) = 0;
+
+  /**
+   * @brief axis aligned bounds of the curve between times t0 and t1
+   *
+   * The default implementation samples the curve and pads the box by the
+   * largest deviation linear interpolation could miss given the sampled
+   * second derivative. Curves with a closed form override this with exact
+   * bounds.
+   *
+   * @param t0 start time
+   * @param t1 end time
+   * @return box in internal units
+   */
+  virtual Box bounds(Float t0, Float t1) {
+    constexpr size_t samples = 32;
+    Box box;
+    Float max_ddf = 0;
+    for (size_t i = 0; i <= samples; i++) {
+      const Float t = t0 + (t1 - t0) * i / samples;
+      const PointType p = f(t);
+      box.expand(p.x.internal(), p.y.internal());
+      max_ddf = std::max(max_ddf, ddf(t).magnitude().internal());
+    }
+
+    // linear interpolation is off by at most |f''| h^2 / 8
+    const Float h = (t1 - t0) / samples;
+    return box.padded(max_ddf * h * h / 8);
+  }
+
+  // axis aligned bounds of the whole curve, cached until the curve changes
+  Box bounds() {
+    return m_bounds_cache.get(m_version, [this] { return bounds(0, 1); });
+  }
+
+  /**
+   * @brief selects how arc length is integrated on this curve
+   *
+   * @param integration method, tolerance (over the whole curve) and maximum
+   * subdivision depth
+   */
+  virtual void setIntegration(geometry::Integration integration) {
+    m_integration = integration;
+    invalidate_total_distance();
+  }
+
+  const geometry::Integration &integration() const { return m_integration; }
+
+  // number of speed evaluations spent integrating arc length so far
+  size_t integrationCost() const { return m_integration_cost; }
+
+  void resetIntegrationCost() { m_integration_cost = 0; }
 
-  Curve(Point first_endpoint, Point last_endpoint)
+  BasicCurve(Point first_endpoint, Point last_endpoint)
       : endpoints({first_endpoint, last_endpoint}) {}
 
-  Curve(std::array<Point, 2> endpoints) : endpoints(endpoints) {}
+  BasicCurve(std::array<Point, 2> endpoints) : endpoints(endpoints) {}
+
+  void updateCurveEndpoints(Point start, Point end) {
+    endpoints = {start, end};
+    m_version++;
+  }
+
+  // incremented every time the shape of the curve changes
+  uint64_t version() const { return m_version; }
+
+  // flattened polyline shared by the renderer and geometric queries, see
+  // geometry::flattened
+  geometry::VersionedCache<Polyline> &polylineCache() {
+    return m_polyline_cache;
+  }
+
+  // curvature extrema used for velocity limits, see
+  // geometry::curvature_extrema
+  geometry::VersionedCache<CurvatureExtrema> &curvatureCache() {
+    return m_curvature_cache;
+  }
 
-  void updateCurveEndpoints(Point start, Point end) { endpoints = {start, end}; }
+  // Chebyshev fit of t(s), see geometry::inverse_arc_length
+  geometry::VersionedCache<InverseArcLength> &inverseArcLengthCache() {
+    return m_inverse_arc_length_cache;
+  }
 
-  virtual ~Curve() = default;
+  virtual ~BasicCurve() = default;
+
+protected:
+  static std::vector<Float> uniform_times(Float t0, Float t1, size_t n) {
+    std::vector<Float> t(n);
+    const Float dt = uniform_step(t0, t1, n);
+    for (size_t i = 0; i < n; i++) {
+      t[i] = t0 + i * dt;
+    }
+    return t;
+  }
+
+  // length of the whole curve, called by total_distance() when it is stale
+  virtual LengthType compute_total_distance() { return s(1); }
+
+  // forces total_distance() to recompute, for changes that don't alter the
+  // shape (and so the version), like the integration method
+  void invalidate_total_distance() { m_length_cache.invalidate(); }
+
+  // sets the length of the current shape when it is already known, e.g. from
+  // the arc length of the curve this one was cut from
+  void seed_total_distance(LengthType length) {
+    m_length_cache.set(m_version, length);
+  }
+
+  geometry::Integration m_integration;
+  size_t m_integration_cost = 0;
+  uint64_t m_version = 0;
+
+private:
+  geometry::VersionedCache<LengthType> m_length_cache;
+  geometry::VersionedCache<Box> m_bounds_cache;
+  geometry::VersionedCache<Polyline> m_polyline_cache;
+  geometry::VersionedCache<CurvatureExtrema> m_curvature_cache;
+  geometry::VersionedCache<InverseArcLength> m_inverse_arc_length_cache;
 };
+
+// float curves are the default, used for realtime previews and the GUI
+using Curve = BasicCurve<float>;
+// double precision curves, used for offline trajectory generation
+using DCurve = BasicCurve<double>;
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <vector>
+
+namespace geometry {
+
+// results of the curve analyses in Curvature.h and InverseArcLength.h, kept
+// apart from them so that Curve.h can cache them
+
+/**
+ * @brief local extrema of a curve's signed curvature
+ *
+ * Includes both ends of the curve, so the largest magnitude over the whole
+ * curve is always one of the entries.
+ */
+template <std::floating_point Float> struct BasicCurvatureExtrema {
+  struct Extremum {
+    Float t;
+    // signed curvature, in radians per meter
+    Float curvature;
+  };
+
+  // ordered by time
+  std::vector<Extremum> extrema;
+  // entry with the largest curvature magnitude
+  Extremum maximum{0, 0};
+};
+
+using CurvatureExtrema = BasicCurvatureExtrema<float>;
+using DCurvatureExtrema = BasicCurvatureExtrema<double>;
+
+/**
+ * @brief Chebyshev approximation of a curve's time by distance, t(s)
+ *
+ * Evaluating it is a fixed number of multiply-adds (Clenshaw's recurrence)
+ * with no table and no iteration, so it suits exporting paths to the robot
+ * as a handful of coefficients.
+ */
+template <std::floating_point Float> struct BasicInverseArcLength {
+  // Chebyshev coefficients over s in [0, length], the constant term halved
+  std::vector<Float> coefficients;
+  // length of the curve, in meters
+  Float length = 0;
+  // largest distance between s and s(t(s)) found on the curve, in meters
+  Float max_error = 0;
+
+  size_t degree() const {
+    return coefficients.empty() ? 0 : coefficients.size() - 1;
+  }
+
+  // time at distance s (in meters) from the start of the curve
+  Float t(Float s) const {
+    if (coefficients.empty() || length <= 0)
+      return 0;
+
+    const Float x = std::clamp(2 * s / length - 1, Float(-1), Float(1));
+    Float b1 = 0, b2 = 0;
+    for (size_t k = coefficients.size() - 1; k > 0; k--) {
+      const Float b = 2 * x * b1 - b2 + coefficients[k];
+      b2 = b1;
+      b1 = b;
+    }
+    return std::clamp(x * b1 - b2 + coefficients[0], Float(0), Float(1));
+  }
+};
+
+using InverseArcLength = BasicInverseArcLength<float>;
+using DInverseArcLength = BasicInverseArcLength<double>;
+
+} // namespace geometry
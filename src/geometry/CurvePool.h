@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief arena that owns many curves of one type
+ *
+ * Curves are constructed in place inside large blocks instead of being
+ * allocated one by one, so importing a log of 100k segments costs a handful
+ * of allocations and the segments end up next to each other in memory.
+ * Pointers stay valid until clear(), since blocks are never moved. Single
+ * curves can't be freed, the pool is cleared as a whole (e.g. when the scene
+ * is reset).
+ *
+ * @tparam T curve type, e.g. CubicBezier
+ */
+template <typename T> class CurvePool {
+public:
+  /**
+   * @param block_size number of curves in each block allocated on demand
+   */
+  explicit CurvePool(size_t block_size = 256)
+      : m_block_size(std::max<size_t>(block_size, 1)) {}
+
+  CurvePool(const CurvePool &) = delete;
+  CurvePool &operator=(const CurvePool &) = delete;
+
+  ~CurvePool() { clear(); }
+
+  /**
+   * @brief constructs a curve in the pool
+   *
+   * @param args forwarded to the constructor of T
+   * @return the curve, owned by the pool
+   */
+  template <typename... Args> T *create(Args &&...args) {
+    if (m_blocks.empty() || m_blocks.back().full())
+      allocate(m_block_size);
+
+    Block &block = m_blocks.back();
+    T *curve = new (block.data + block.used) T(std::forward<Args>(args)...);
+    block.used++;
+    m_size++;
+    return curve;
+  }
+
+  /**
+   * @brief makes room for count more curves in a single block
+   *
+   * Call before a bulk import so the whole import lands in one allocation.
+   */
+  void reserve(size_t count) {
+    if (m_blocks.empty() ||
+        m_blocks.back().capacity - m_blocks.back().used < count)
+      allocate(std::max(count, m_block_size));
+  }
+
+  // number of curves in the pool
+  size_t size() const { return m_size; }
+
+  // destroys every curve and frees the blocks
+  void clear() {
+    for (auto block = m_blocks.rbegin(); block != m_blocks.rend(); ++block) {
+      std::destroy_n(block->data, block->used);
+      std::allocator<T>().deallocate(block->data, block->capacity);
+    }
+    m_blocks.clear();
+    m_size = 0;
+  }
+
+private:
+  struct Block {
+    T *data;
+    size_t capacity;
+    size_t used;
+
+    bool full() const { return used == capacity; }
+  };
+
+  void allocate(size_t capacity) {
+    // grows the block list first, so a failure there can't leak the block
+    m_blocks.reserve(m_blocks.size() + 1);
+    m_blocks.push_back(
+        {std::allocator<T>().allocate(capacity), capacity, size_t(0)});
+  }
+
+  size_t m_block_size;
+  size_t m_size = 0;
+  std::vector<Block> m_blocks;
+};
+
+} // namespace geometry
@@ -0,0 +1,270 @@
+#pragma once
+
+#include "../utils.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <future>
+#include <span>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace geometry {
+
+namespace detail {
+
+// raw vector in meters, the fitter runs thousands of tiny dot products
+struct FitVector {
+  double x;
+  double y;
+
+  FitVector operator+(FitVector o) const { return {x + o.x, y + o.y}; }
+  FitVector operator-(FitVector o) const { return {x - o.x, y - o.y}; }
+  FitVector operator*(double s) const { return {x * s, y * s}; }
+  double dot(FitVector o) const { return x * o.x + y * o.y; }
+  double length() const { return std::hypot(x, y); }
+
+  FitVector normalized() const {
+    const double l = length();
+    return l > 0 ? FitVector{x / l, y / l} : FitVector{0, 0};
+  }
+};
+
+/**
+ * @brief least squares cubic fitting with error driven subdivision
+ *
+ * Follows Schneider's algorithm from Graphics Gems: fit one cubic with fixed
+ * end tangents to a run of points, improve the parameterization with Newton
+ * steps while the error is close to the tolerance, and otherwise split at
+ * the worst point and fit both halves.
+ */
+struct BezierFitter {
+  using Controls = std::array<FitVector, 4>;
+
+  std::span<const FitVector> points;
+  double tolerance;
+  std::vector<Controls> &out;
+
+  static constexpr int max_reparameterizations = 4;
+
+  static FitVector evaluate(const Controls &c, double t) {
+    const double s = 1 - t;
+    return c[0] * (s * s * s) + c[1] * (3 * s * s * t) +
+           c[2] * (3 * s * t * t) + c[3] * (t * t * t);
+  }
+
+  // fits points [first, last] with the given unit end tangents, the right
+  // tangent points back towards the inside of the run
+  void fit(size_t first, size_t last, FitVector left, FitVector right) {
+    if (last - first == 1) {
+      out.push_back(heuristic(first, last, left, right));
+      return;
+    }
+
+    std::vector<double> u = chord_parameters(first, last);
+    Controls controls = generate(first, last, u, left, right);
+    auto [error, split] = max_error(first, last, controls, u);
+    if (error < tolerance * tolerance) {
+      out.push_back(controls);
+      return;
+    }
+
+    // close enough that a better parameterization may be all it takes
+    if (error < 4 * tolerance * tolerance) {
+      for (int i = 0; i < max_reparameterizations; i++) {
+        reparameterize(first, last, controls, u);
+        controls = generate(first, last, u, left, right);
+        std::tie(error, split) = max_error(first, last, controls, u);
+        if (error < tolerance * tolerance) {
+          out.push_back(controls);
+          return;
+        }
+      }
+    }
+
+    // the tangent at the split is shared by both halves, keeping them G1
+    FitVector center = (points[split - 1] - points[split + 1]).normalized();
+    if (center.length() == 0)
+      center = FitVector{-right.y, right.x};
+    fit(first, split, left, center);
+    fit(split, last, center * -1, right);
+  }
+
+  std::vector<double> chord_parameters(size_t first, size_t last) const {
+    std::vector<double> u(last - first + 1);
+    u[0] = 0;
+    for (size_t i = first + 1; i <= last; i++) {
+      u[i - first] = u[i - first - 1] + (points[i] - points[i - 1]).length();
+    }
+    const double total = u.back();
+    for (double &value : u) {
+      value = total > 0 ? value / total : 0;
+    }
+    return u;
+  }
+
+  // handles a third of the chord long, for runs too short to fit
+  Controls heuristic(size_t first, size_t last, FitVector left,
+                     FitVector right) const {
+    const double distance = (points[last] - points[first]).length() / 3;
+    return {points[first], points[first] + left * distance,
+            points[last] + right * distance, points[last]};
+  }
+
+  // least squares handle lengths along the fixed end tangents
+  Controls generate(size_t first, size_t last, const std::vector<double> &u,
+                    FitVector left, FitVector right) const {
+    const FitVector p0 = points[first], p3 = points[last];
+    double c00 = 0, c01 = 0, c11 = 0, x0 = 0, x1 = 0;
+    for (size_t i = 0; i < u.size(); i++) {
+      const double t = u[i], s = 1 - t;
+      const double b0 = s * s * s, b1 = 3 * s * s * t;
+      const double b2 = 3 * s * t * t, b3 = t * t * t;
+      const FitVector a0 = left * b1, a1 = right * b2;
+      c00 += a0.dot(a0);
+      c01 += a0.dot(a1);
+      c11 += a1.dot(a1);
+      const FitVector rest =
+          points[first + i] - (p0 * (b0 + b1) + p3 * (b2 + b3));
+      x0 += a0.dot(rest);
+      x1 += a1.dot(rest);
+    }
+
+    const double determinant = c00 * c11 - c01 * c01;
+    double alpha_left = 0, alpha_right = 0;
+    if (determinant != 0) {
+      alpha_left = (x0 * c11 - x1 * c01) / determinant;
+      alpha_right = (c00 * x1 - c01 * x0) / determinant;
+    }
+
+    // degenerate or backwards handles fall back to the heuristic
+    const double segment_length = (p3 - p0).length();
+    const double epsilon = 1e-6 * segment_length;
+    if (alpha_left < epsilon || alpha_right < epsilon)
+      return heuristic(first, last, left, right);
+
+    return {p0, p0 + left * alpha_left, p3 + right * alpha_right, p3};
+  }
+
+  // largest squared distance between a point and the curve at its parameter
+  std::pair<double, size_t> max_error(size_t first, size_t last,
+                                      const Controls &controls,
+                                      const std::vector<double> &u) const {
+    double worst = 0;
+    size_t split = (first + last) / 2;
+    for (size_t i = first + 1; i < last; i++) {
+      const FitVector d = evaluate(controls, u[i - first]) - points[i];
+      const double error = d.dot(d);
+      if (error >= worst) {
+        worst = error;
+        split = i;
+      }
+    }
+    return {worst, split};
+  }
+
+  // one Newton step per point towards the closest point on the curve
+  void reparameterize(size_t first, size_t last, const Controls &c,
+                      std::vector<double> &u) const {
+    const std::array<FitVector, 3> d1{(c[1] - c[0]) * 3, (c[2] - c[1]) * 3,
+                                      (c[3] - c[2]) * 3};
+    const std::array<FitVector, 2> d2{(d1[1] - d1[0]) * 2,
+                                      (d1[2] - d1[1]) * 2};
+    for (size_t i = first; i <= last; i++) {
+      const double t = u[i - first], s = 1 - t;
+      const FitVector diff = evaluate(c, t) - points[i];
+      const FitVector first_derivative =
+          d1[0] * (s * s) + d1[1] * (2 * s * t) + d1[2] * (t * t);
+      const FitVector second_derivative = d2[0] * s + d2[1] * t;
+      const double numerator = diff.dot(first_derivative);
+      const double denominator = first_derivative.dot(first_derivative) +
+                                 diff.dot(second_derivative);
+      if (denominator != 0)
+        u[i - first] = std::clamp(t - numerator / denominator, 0.0, 1.0);
+    }
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief fits cubic beziers to a stream of recorded positions
+ *
+ * Consecutive duplicate samples (a stationary robot) are dropped, and the
+ * stream is cut into chunks that are fitted in parallel. Neighbouring
+ * chunks share the tangent at their common sample, so the whole result is
+ * G1 continuous. Within a chunk, cubics are fitted by least squares and
+ * split at the worst sample until every sample is within tolerance.
+ *
+ * @param samples recorded positions, in order
+ * @param tolerance largest allowed distance between a sample and the fit
+ * @param threads number of chunks fitted in parallel, 0 for one per core
+ * @return controls of each fitted segment, in order. Each can be passed to
+ * the CubicBezier constructor
+ */
+inline std::vector<std::array<Point, 4>>
+fit_beziers(std::span<const Point> samples, Length tolerance,
+            size_t threads = 0) {
+  using detail::FitVector;
+
+  std::vector<FitVector> points;
+  points.reserve(samples.size());
+  const double tol = std::max(tolerance.internal(), 1e-9);
+  for (const Point &sample : samples) {
+    const FitVector p{sample.x.internal(), sample.y.internal()};
+    if (points.empty() || (p - points.back()).length() > tol * 1e-3)
+      points.push_back(p);
+  }
+
+  std::vector<std::array<Point, 4>> result;
+  if (points.size() < 2)
+    return result;
+
+  // chunks are kept long enough that splitting them costs little accuracy
+  constexpr size_t min_chunk = 256;
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  const size_t chunks =
+      std::clamp<size_t>((points.size() - 1) / min_chunk, 1, threads);
+
+  // unit tangent at sample i, pointing forwards
+  auto tangent = [&points](size_t i) {
+    const size_t before = i == 0 ? 0 : i - 1;
+    const size_t after = std::min(i + 1, points.size() - 1);
+    return (points[after] - points[before]).normalized();
+  };
+
+  const size_t last = points.size() - 1;
+  std::vector<std::vector<detail::BezierFitter::Controls>> fitted(chunks);
+  std::vector<std::future<void>> tasks;
+  for (size_t c = 0; c < chunks; c++) {
+    const size_t first = last * c / chunks;
+    const size_t end = last * (c + 1) / chunks;
+    auto task = [&, first, end, c] {
+      detail::BezierFitter fitter{points, tol, fitted[c]};
+      fitter.fit(first, end, tangent(first), tangent(end) * -1);
+    };
+    if (c + 1 == chunks)
+      task();
+    else
+      tasks.push_back(std::async(std::launch::async, task));
+  }
+  for (auto &task : tasks) {
+    task.get();
+  }
+
+  for (const auto &chunk : fitted) {
+    for (const auto &controls : chunk) {
+      std::array<Point, 4> segment;
+      for (size_t i = 0; i < 4; i++) {
+        segment[i] = Point(controls[i].x * m, controls[i].y * m);
+      }
+      result.push_back(segment);
+    }
+  }
+  return result;
+}
+
+} // namespace geometry
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "Bezier.h"
+#include "QuinticBezier.h"
+#include "Samples.h"
+#include "Split.h"
+#include "StaticCurve.h"
+#include <algorithm>
+#include <cmath>
+
+namespace geometry {
+
+namespace detail {
+
+template <StaticCurve C> struct Flattener {
+  using Float = typename C::Scalar;
+  using PointType = typename C::PointType;
+
+  C &curve;
+  Float tolerance;
+  BasicPolyline<Float> &out;
+
+  // curves without control points are always split this many times, so
+  // features smaller than the whole curve (loops, s-bends) are sampled more
+  // than a few times before an interval is accepted. The control point test
+  // is exact and needs no minimum
+  static constexpr int min_depth = ControlPointCurve<C> ? 0 : 2;
+  static constexpr int max_depth = 16;
+  // samples per interval checked against the chord, without control points
+  static constexpr int samples = 8;
+
+  // appends the vertices after t0 up to and including t1
+  void subdivide(Float t0, PointType p0, Float t1, PointType p1, int depth) {
+    const Float tm = (t0 + t1) / 2;
+    const PointType pm = curve.f(tm);
+
+    if (depth >= min_depth &&
+        (depth >= max_depth || flat(t0, p0, tm, pm, t1, p1))) {
+      out.push_back(t1, p1.x.internal(), p1.y.internal());
+      return;
+    }
+
+    subdivide(t0, p0, tm, pm, depth + 1);
+    subdivide(tm, pm, t1, p1, depth + 1);
+  }
+
+  // whether the chord p0 p1 is within tolerance of the curve between them
+  bool flat(Float t0, PointType p0, Float tm, PointType pm, Float t1,
+            PointType p1) {
+    const Float ax = p0.x.internal(), ay = p0.y.internal();
+    const Float bx = p1.x.internal(), by = p1.y.internal();
+    const Float tolerance2 = tolerance * tolerance;
+
+    if constexpr (ControlPointCurve<C>) {
+      // the piece lies in the hull of its control points, and so within
+      // tolerance of the chord if all of them are
+      const auto controls =
+          geometry::subcurve_controls(curve.getControlPoints(), t0, t1);
+      for (size_t i = 1; i + 1 < controls.size(); i++) {
+        if (chord_distance2(ax, ay, bx, by, controls[i].x.internal(),
+                            controls[i].y.internal()) > tolerance2)
+          return false;
+      }
+      return true;
+    } else {
+      for (int i = 1; i < samples; i++) {
+        const PointType p =
+            i * 2 == samples ? pm : curve.f(t0 + (t1 - t0) * i / samples);
+        if (chord_distance2(ax, ay, bx, by, p.x.internal(), p.y.internal()) >
+            tolerance2)
+          return false;
+      }
+
+      // sagitta of a circle with the curvature at the midpoint, catches
+      // bends between the samples
+      const Float cx = bx - ax, cy = by - ay;
+      const Float curvature = std::abs(curve.c(tm).internal());
+      return (cx * cx + cy * cy) * curvature <= 8 * tolerance;
+    }
+  }
+
+  // squared distance from x, y to the chord a b, a segment
+  static Float chord_distance2(Float ax, Float ay, Float bx, Float by, Float x,
+                               Float y) {
+    const Float cx = bx - ax, cy = by - ay;
+    const Float chord2 = cx * cx + cy * cy;
+    const Float u =
+        chord2 > 0
+            ? std::clamp(((x - ax) * cx + (y - ay) * cy) / chord2, Float(0),
+                         Float(1))
+            : Float(0);
+    const Float dx = ax + u * cx - x, dy = ay + u * cy - y;
+    return dx * dx + dy * dy;
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief flattens a curve to a polyline within a chord error tolerance
+ *
+ * Intervals are bisected until the curve between their ends is within
+ * tolerance of the chord, so nearly straight parts use few vertices and tight
+ * turns use many. For beziers that is guaranteed by checking the control
+ * points of the piece against the chord. Other curves are sampled along the
+ * interval and checked against the sagitta implied by the local curvature,
+ * which catches all but features much smaller than the interval.
+ *
+ * @param curve curve to flatten
+ * @param tolerance target distance between the polyline and the curve
+ * @return polyline starting at t = 0 and ending at t = 1
+ */
+template <StaticCurve C>
+BasicPolyline<typename C::Scalar> flatten(C &curve,
+                                          typename C::LengthType tolerance) {
+  using Float = typename C::Scalar;
+
+  // beziers behind the Curve interface are flattened through their control
+  // points as well
+  if constexpr (std::same_as<C, BasicCurve<Float>>) {
+    if (auto *cubic = dynamic_cast<BasicCubicBezier<Float> *>(&curve))
+      return flatten(*cubic, tolerance);
+    if (auto *quintic = dynamic_cast<BasicQuinticBezier<Float> *>(&curve))
+      return flatten(*quintic, tolerance);
+  }
+
+  BasicPolyline<Float> out;
+  out.tolerance = std::max(tolerance.internal(), Float(1e-9));
+
+  const auto start = curve.f(0);
+  out.push_back(0, start.x.internal(), start.y.internal());
+
+  detail::Flattener<C> flattener{curve, out.tolerance, out};
+  flattener.subdivide(0, start, 1, curve.f(1), 0);
+  return out;
+}
+
+/**
+ * @brief returns the curve's cached polyline, flattening it if needed
+ *
+ * The polyline is kept until the control points change or a different
+ * tolerance is requested, so the renderer and geometric queries can share it.
+ *
+ * @param curve curve to flatten
+ * @param tolerance target distance between the polyline and the curve
+ */
+template <std::floating_point Float>
+const BasicPolyline<Float> &
+flattened(BasicCurve<Float> &curve,
+          typename BasicCurve<Float>::LengthType tolerance) {
+  auto &cache = curve.polylineCache();
+  // a different tolerance invalidates the polyline as well
+  const Float requested = std::max(tolerance.internal(), Float(1e-9));
+  if (cache.valid(curve.version()) && cache.value().tolerance != requested)
+    cache.invalidate();
+
+  return cache.get(curve.version(),
+                   [&curve, tolerance] { return flatten(curve, tolerance); });
+}
+
+} // namespace geometry
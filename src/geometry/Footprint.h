@@ -0,0 +1,378 @@
+#pragma once
+
+#include "Bezier.h"
+#include "Bounds.h"
+#include "Polygon.h"
+#include "QuinticBezier.h"
+#include "SplinePath.h"
+#include "Split.h"
+#include "StaticCurve.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief rectangle rotated to a heading, in internal units
+ *
+ * The length runs along the heading (ux, uy) and the width across it, like
+ * RobotElementProperties' robotHeight and robotWidth.
+ */
+template <std::floating_point Float> struct BasicOrientedBox {
+  Float x;
+  Float y;
+  // unit vector of the heading
+  Float ux;
+  Float uy;
+  Float half_length;
+  Float half_width;
+
+  // corners in counter clockwise order, starting at the front left
+  std::array<std::array<Float, 2>, 4> corners() const {
+    const Float lx = ux * half_length, ly = uy * half_length;
+    const Float wx = -uy * half_width, wy = ux * half_width;
+    return {{{x + lx + wx, y + ly + wy},
+             {x - lx + wx, y - ly + wy},
+             {x - lx - wx, y - ly - wy},
+             {x + lx - wx, y + ly - wy}}};
+  }
+
+  BasicBox<Float> bounds() const {
+    const Float ex = std::abs(ux) * half_length + std::abs(uy) * half_width;
+    const Float ey = std::abs(uy) * half_length + std::abs(ux) * half_width;
+    return {x - ex, y - ey, x + ex, y + ey};
+  }
+
+  // squared distance from a point to the rectangle, zero inside it
+  Float distance2(Float px, Float py) const {
+    const Float dx = px - x, dy = py - y;
+    const Float along = std::abs(dx * ux + dy * uy) - half_length;
+    const Float across = std::abs(dy * ux - dx * uy) - half_width;
+    const Float a = std::max(along, Float(0));
+    const Float b = std::max(across, Float(0));
+    return a * a + b * b;
+  }
+
+  // separating axis test against a convex polygon
+  bool intersects(const BasicPolygon<Float> &polygon) const {
+    const size_t n = polygon.size();
+    if (n == 0)
+      return false;
+    const auto &px = polygon.points.x;
+    const auto &py = polygon.points.y;
+
+    // the polygon's extent along an axis, relative to the rectangle center
+    auto separated = [&](Float ax, Float ay, Float extent) {
+      Float lo = std::numeric_limits<Float>::infinity();
+      Float hi = -lo;
+      for (size_t i = 0; i < n; i++) {
+        const Float d = (px[i] - x) * ax + (py[i] - y) * ay;
+        lo = std::min(lo, d);
+        hi = std::max(hi, d);
+      }
+      return lo > extent || hi < -extent;
+    };
+
+    if (separated(ux, uy, half_length) || separated(-uy, ux, half_width))
+      return false;
+
+    // winding of the polygon, so edge normals can be made to point outwards
+    Float area = 0;
+    for (size_t i = 0; i < n; i++) {
+      const size_t j = i + 1 == n ? 0 : i + 1;
+      area += px[i] * py[j] - px[j] * py[i];
+    }
+    const Float outwards = area < 0 ? -1 : 1;
+
+    for (size_t i = 0; i < n; i++) {
+      const size_t j = i + 1 == n ? 0 : i + 1;
+      const Float nx = outwards * (py[j] - py[i]);
+      const Float ny = outwards * (px[i] - px[j]);
+
+      // the rectangle lies entirely outside this edge
+      const Float center = (x - px[i]) * nx + (y - py[i]) * ny;
+      const Float radius = half_length * std::abs(ux * nx + uy * ny) +
+                           half_width * std::abs(ux * ny - uy * nx);
+      if (center > radius)
+        return false;
+    }
+    return true;
+  }
+};
+
+using OrientedBox = BasicOrientedBox<float>;
+using DOrientedBox = BasicOrientedBox<double>;
+
+/**
+ * @brief area covered by a robot following a path
+ *
+ * Stored as the robot's rectangle at a sequence of poses, each padded by the
+ * tolerance. Every pose of the robot between two neighbouring poses is
+ * within the tolerance of one of them, so the union of the rectangles
+ * covers the continuous sweep. For beziers that is guaranteed through the
+ * control points, other curves are sampled (see sweep()).
+ */
+template <std::floating_point Float> struct BasicSweptFootprint {
+  std::vector<BasicOrientedBox<Float>> boxes;
+  // curve time of each box, for spline paths offset by the segment index
+  std::vector<Float> t;
+  BasicBox<Float> box;
+  // padding of every rectangle, in meters
+  Float tolerance = 0;
+
+  size_t size() const { return boxes.size(); }
+
+  void push_back(Float time, const BasicOrientedBox<Float> &rectangle) {
+    boxes.push_back(rectangle);
+    t.push_back(time);
+    box.expand(rectangle.bounds());
+  }
+
+  // whether the sweep overlaps a convex polygon
+  bool intersects(const BasicPolygon<Float> &polygon) const {
+    const BasicBox<Float> polygon_box = polygon.bounds();
+    if (!box.intersects(polygon_box))
+      return false;
+    return std::any_of(boxes.begin(), boxes.end(), [&](const auto &r) {
+      return r.bounds().intersects(polygon_box) && r.intersects(polygon);
+    });
+  }
+
+  // whether the sweep comes within radius of a point, e.g. a round element
+  bool intersects(Float x, Float y, Float radius) const {
+    const Float radius2 = radius * radius;
+    if (box.distance2(x, y) > radius2)
+      return false;
+    return std::any_of(boxes.begin(), boxes.end(), [&](const auto &r) {
+      return r.distance2(x, y) <= radius2;
+    });
+  }
+
+  // whether the sweep stays inside a box, e.g. the field walls
+  bool inside(const BasicBox<Float> &field) const {
+    return field.contains(box.min_x, box.min_y) &&
+           field.contains(box.max_x, box.max_y);
+  }
+};
+
+using SweptFootprint = BasicSweptFootprint<float>;
+using DSweptFootprint = BasicSweptFootprint<double>;
+
+namespace detail {
+
+template <StaticCurve C> struct Sweeper {
+  using Float = typename C::Scalar;
+
+  struct Pose {
+    Float x;
+    Float y;
+    Float ux;
+    Float uy;
+  };
+
+  C &curve;
+  Float half_length;
+  Float half_width;
+  // twice the largest distance from a pose to the nearer of its neighbours
+  Float step;
+  BasicSweptFootprint<Float> &out;
+  Float offset = 0;
+
+  // as in Flattener, curves without control points are split a few times
+  // before their samples are trusted
+  static constexpr int min_depth = ControlPointCurve<C> ? 0 : 2;
+  static constexpr int max_depth = 16;
+  // poses per interval checked against its ends, without control points
+  static constexpr int samples = 4;
+
+  Pose pose(Float t) {
+    const auto p = curve.f(t);
+    auto d = curve.df(t);
+    Float dx = d.x.internal(), dy = d.y.internal();
+    Float norm = std::hypot(dx, dy);
+
+    // where the curve stops (e.g. a control point on an endpoint), the
+    // heading is the direction of the second derivative
+    if (norm < Float(1e-6)) {
+      const auto dd = curve.ddf(t);
+      const Float sign = t < Float(0.5) ? 1 : -1;
+      dx = sign * dd.x.internal();
+      dy = sign * dd.y.internal();
+      norm = std::hypot(dx, dy);
+      if (norm == 0) {
+        dx = 0;
+        dy = norm = 1;
+      }
+    }
+    return {p.x.internal(), p.y.internal(), dx / norm, dy / norm};
+  }
+
+  void add(Float t, const Pose &p) {
+    const Float padding = out.tolerance;
+    out.push_back(offset + t, {p.x, p.y, p.ux, p.uy, half_length + padding,
+                               half_width + padding});
+  }
+
+  // distance the farthest point of the robot moves between two poses
+  Float moved(const Pose &a, const Pose &b) {
+    const Float turn = std::abs(
+        std::atan2(a.ux * b.uy - a.uy * b.ux, a.ux * b.ux + a.uy * b.uy));
+    return std::hypot(b.x - a.x, b.y - a.y) +
+           turn * std::hypot(half_length, half_width);
+  }
+
+  // largest turn from a heading to any direction between lo and hi, the
+  // extreme angles of the control polygon's legs relative to it. Infinite if
+  // the legs span half a turn or more, since the headings in between are
+  // then unknown
+  static Float turn_bound(Float lo, Float hi) {
+    if (hi - lo >= std::numbers::pi_v<Float>)
+      return std::numeric_limits<Float>::infinity();
+    return std::max(std::abs(lo), std::abs(hi));
+  }
+
+  // whether every pose between t0 and t1 is within step / 2 of p0 or p1
+  bool covered(Float t0, const Pose &p0, const Pose &pm, Float t1,
+               const Pose &p1) {
+    const Float radius = std::hypot(half_length, half_width);
+
+    if constexpr (ControlPointCurve<C>) {
+      // the distance travelled is at most the length of the piece's control
+      // polygon, and every heading on it lies between the directions of the
+      // legs. A point at radius r turned by a moves at most r a, so a pose
+      // that has travelled d0 and turned a0 from p0 is within d0 + r a0 of
+      // it, and the nearer end is at most half of the sum for both ends
+      const auto controls =
+          geometry::subcurve_controls(curve.getControlPoints(), t0, t1);
+      Float length = 0;
+      Float lo0 = 0, hi0 = 0, lo1 = 0, hi1 = 0;
+      for (size_t i = 0; i + 1 < controls.size(); i++) {
+        const Float dx = (controls[i + 1].x - controls[i].x).internal();
+        const Float dy = (controls[i + 1].y - controls[i].y).internal();
+        const Float leg = std::hypot(dx, dy);
+        if (leg == 0)
+          continue;
+        length += leg;
+        const Float a0 =
+            std::atan2(p0.ux * dy - p0.uy * dx, p0.ux * dx + p0.uy * dy);
+        const Float a1 =
+            std::atan2(p1.ux * dy - p1.uy * dx, p1.ux * dx + p1.uy * dy);
+        lo0 = std::min(lo0, a0);
+        hi0 = std::max(hi0, a0);
+        lo1 = std::min(lo1, a1);
+        hi1 = std::max(hi1, a1);
+      }
+      const Float turn = turn_bound(lo0, hi0) + turn_bound(lo1, hi1);
+      return length + turn * radius <= step;
+    } else {
+      if (moved(p0, p1) > step)
+        return false;
+      for (int i = 1; i < samples; i++) {
+        const Pose p =
+            i * 2 == samples ? pm : pose(t0 + (t1 - t0) * i / samples);
+        if (2 * std::min(moved(p0, p), moved(p, p1)) > step)
+          return false;
+      }
+      return true;
+    }
+  }
+
+  // adds the poses after t0 up to and including t1
+  void subdivide(Float t0, const Pose &p0, Float t1, const Pose &p1,
+                 int depth) {
+    const Float tm = (t0 + t1) / 2;
+    const Pose pm = pose(tm);
+
+    if (depth >= min_depth &&
+        (depth >= max_depth || covered(t0, p0, pm, t1, p1))) {
+      add(t1, p1);
+      return;
+    }
+
+    subdivide(t0, p0, tm, pm, depth + 1);
+    subdivide(tm, pm, t1, p1, depth + 1);
+  }
+
+  void sweep() {
+    const Pose start = pose(0);
+    add(0, start);
+    subdivide(0, start, 1, pose(1), 0);
+  }
+};
+
+// sweeps a curve into out, with beziers behind the Curve interface swept
+// through their control points
+template <StaticCurve C>
+void sweep_into(C &curve, typename C::Scalar half_length,
+                typename C::Scalar half_width,
+                BasicSweptFootprint<typename C::Scalar> &out,
+                typename C::Scalar offset) {
+  using Float = typename C::Scalar;
+  if constexpr (std::same_as<C, BasicCurve<Float>>) {
+    if (auto *cubic = dynamic_cast<BasicCubicBezier<Float> *>(&curve))
+      return sweep_into(*cubic, half_length, half_width, out, offset);
+    if (auto *quintic = dynamic_cast<BasicQuinticBezier<Float> *>(&curve))
+      return sweep_into(*quintic, half_length, half_width, out, offset);
+  }
+
+  Sweeper<C> sweeper{curve, half_length, half_width, 2 * out.tolerance, out,
+                     offset};
+  sweeper.sweep();
+}
+
+} // namespace detail
+
+/**
+ * @brief area swept by a rectangular robot following a curve
+ *
+ * The robot faces along the curve's tangent. Poses are placed by bisecting
+ * the curve until every pose in between is within the tolerance of a
+ * neighbouring pose, so straight runs use few rectangles and turns use
+ * many. For beziers the motion inside an interval is bounded by the control
+ * points of the piece. Other curves are checked at a few poses along each
+ * interval, which catches all but features much smaller than the interval.
+ *
+ * @param curve curve followed by the robot's center
+ * @param length robot size along its heading (robotHeight)
+ * @param width robot size across its heading (robotWidth)
+ * @param tolerance padding of the rectangles, larger is coarser and faster
+ */
+template <StaticCurve C>
+BasicSweptFootprint<typename C::Scalar>
+sweep(C &curve, typename C::LengthType length, typename C::LengthType width,
+      typename C::LengthType tolerance) {
+  using Float = typename C::Scalar;
+
+  BasicSweptFootprint<Float> out;
+  out.tolerance = std::max(tolerance.internal(), Float(1e-6));
+  detail::sweep_into(curve, length.internal() / 2, width.internal() / 2, out,
+                     Float(0));
+  return out;
+}
+
+/**
+ * @brief area swept by a rectangular robot following a spline path
+ *
+ * Segments are swept one after another. Times in the result are the segment
+ * index plus the time within the segment.
+ */
+template <std::floating_point Float>
+BasicSweptFootprint<Float>
+sweep(BasicSplinePath<Float> &path,
+      typename BasicCurve<Float>::LengthType length,
+      typename BasicCurve<Float>::LengthType width,
+      typename BasicCurve<Float>::LengthType tolerance) {
+  BasicSweptFootprint<Float> out;
+  out.tolerance = std::max(tolerance.internal(), Float(1e-6));
+  for (size_t i = 0; i < path.size(); i++) {
+    detail::sweep_into(path.segment(i), length.internal() / 2,
+                       width.internal() / 2, out, Float(i));
+  }
+  return out;
+}
+
+} // namespace geometry
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <span>
+
+namespace geometry {
+
+namespace detail {
+
+// the power series is used up to this argument and the fit of the
+// auxiliary functions above it. Higher would lose digits to cancellation
+// between the series terms
+inline constexpr double fresnel_switch = 1.8;
+
+// power series terms of C and S each, enough for 1e-16 at fresnel_switch
+inline constexpr size_t fresnel_series_terms = 21;
+
+// coefficients of the series of C(x) / x and S(x) / x^3 in powers of x^4,
+// highest power first so they can be evaluated with horner
+struct FresnelSeries {
+  std::array<double, fresnel_series_terms> c;
+  std::array<double, fresnel_series_terms> s;
+
+  constexpr FresnelSeries() : c(), s() {
+    // w^n / n! with w = pi / 2 x^2, C takes the even n and S the odd ones
+    double factor = 1;
+    for (size_t k = 0; k < fresnel_series_terms; k++) {
+      const double sign = k % 2 == 0 ? 1 : -1;
+      c[fresnel_series_terms - 1 - k] = sign * factor / (4 * k + 1);
+      factor *= std::numbers::pi / 2 / (2 * k + 1);
+      s[fresnel_series_terms - 1 - k] = sign * factor / (4 * k + 3);
+      factor *= std::numbers::pi / 2 / (2 * k + 2);
+    }
+  }
+};
+
+inline constexpr FresnelSeries fresnel_series_coefficients;
+
+inline void fresnel_series(double x, double &c, double &s) {
+  const double x2 = x * x;
+  const double x4 = x2 * x2;
+  const FresnelSeries &series = fresnel_series_coefficients;
+  double sum_c = series.c[0], sum_s = series.s[0];
+  // unrolled so batch loops vectorize across arguments, not terms
+#pragma GCC unroll 32
+  for (size_t k = 1; k < fresnel_series_terms; k++) {
+    sum_c = sum_c * x4 + series.c[k];
+    sum_s = sum_s * x4 + series.s[k];
+  }
+  c = x * sum_c;
+  s = x * x2 * sum_s;
+}
+
+/**
+ * @brief auxiliary functions f(x) and g(x) of the Fresnel integrals by
+ * their continued fraction
+ *
+ * g + i f is x times the continued fraction of the complementary error
+ * function (Numerical Recipes 6.9), evaluated bottom up. It needs a chain
+ * of dozens of divisions near fresnel_switch, so it only builds
+ * FresnelAuxiliaryFit.
+ */
+inline void fresnel_fraction(double x, double &f, double &g) {
+  // deep enough for 1e-16 at fresnel_switch
+  constexpr size_t depth = 60;
+  const double p = std::numbers::pi * x * x;
+  // b_j = 1 + 4 (j - 1) - i p and a_j = -(2j - 3)(2j - 2)
+  double re = 1 + 4.0 * (depth - 1), im = -p;
+  for (size_t j = depth; j >= 2; j--) {
+    const double a = -double(2 * j - 3) * double(2 * j - 2);
+    const double scale = a / (re * re + im * im);
+    re = 1 + 4.0 * (j - 2) + scale * re;
+    im = -p - scale * im;
+  }
+  const double scale = x / (re * re + im * im);
+  g = scale * re;
+  f = -scale * im;
+}
+
+/**
+ * @brief Chebyshev fits of the auxiliary functions for x >= fresnel_switch
+ *
+ * f and g decay like 1 / (pi x) and 1 / (pi^2 x^3). Scaled by those, both
+ * are smooth functions of w = 1 / x^2 on [0, 1 / fresnel_switch^2], which
+ * a few dozen Chebyshev terms fit to about 1e-16, all the way to x = inf.
+ */
+struct FresnelAuxiliaryFit {
+  static constexpr size_t terms = 28;
+  static constexpr double max_w = 1 / (fresnel_switch * fresnel_switch);
+
+  // Chebyshev coefficients of pi x f and pi^2 x^3 g, constant term halved
+  std::array<double, terms> f;
+  std::array<double, terms> g;
+
+  FresnelAuxiliaryFit() {
+    std::array<double, terms> angles, scaled_f, scaled_g;
+    for (size_t k = 0; k < terms; k++) {
+      angles[k] = std::numbers::pi * (k + 0.5) / terms;
+      const double x = 1 / std::sqrt((std::cos(angles[k]) + 1) / 2 * max_w);
+      double fk, gk;
+      fresnel_fraction(x, fk, gk);
+      scaled_f[k] = std::numbers::pi * x * fk;
+      scaled_g[k] = std::numbers::pi * std::numbers::pi * x * x * x * gk;
+    }
+    for (size_t j = 0; j < terms; j++) {
+      double sum_f = 0, sum_g = 0;
+      for (size_t k = 0; k < terms; k++) {
+        const double weight = std::cos(j * angles[k]);
+        sum_f += scaled_f[k] * weight;
+        sum_g += scaled_g[k] * weight;
+      }
+      f[j] = 2 * sum_f / terms;
+      g[j] = 2 * sum_g / terms;
+    }
+    f[0] /= 2;
+    g[0] /= 2;
+  }
+
+  /**
+   * @brief f(x) and g(x) for x >= fresnel_switch
+   *
+   * A fixed number of multiply-adds (Clenshaw's recurrence) with no
+   * branches, like fresnel_series.
+   */
+  void evaluate(double x, double &f_x, double &g_x) const {
+    const double w = 1 / (x * x);
+    const double y = 2 * w / max_w - 1;
+    double f1 = 0, f2 = 0, g1 = 0, g2 = 0;
+#pragma GCC unroll 32
+    for (size_t k = terms - 1; k > 0; k--) {
+      const double next_f = 2 * y * f1 - f2 + f[k];
+      const double next_g = 2 * y * g1 - g2 + g[k];
+      f2 = f1;
+      f1 = next_f;
+      g2 = g1;
+      g1 = next_g;
+    }
+    f_x = (y * f1 - f2 + f[0]) / (std::numbers::pi * x);
+    g_x = (y * g1 - g2 + g[0]) * w /
+          (std::numbers::pi * std::numbers::pi * x);
+  }
+};
+
+// built on first use
+inline const FresnelAuxiliaryFit &fresnel_auxiliary_fit() {
+  static const FresnelAuxiliaryFit fit;
+  return fit;
+}
+
+/**
+ * @brief the parts of the Fresnel integrals that need no trigonometry
+ *
+ * C(x) and S(x) for |x| <= fresnel_switch, f(|x|) and g(|x|) beyond it.
+ * Both the series and the fit are evaluated for every element and the right
+ * one is kept, so the loop has no branches and no calls and vectorizes.
+ *
+ * @param x arguments
+ * @param a filled with C(x) or f(|x|)
+ * @param b filled with S(x) or g(|x|)
+ */
+inline void fresnel_parts_batch(std::span<const double> x, double *__restrict a,
+                                double *__restrict b) {
+  // copied so the outputs can't alias the coefficients
+  const FresnelAuxiliaryFit fit = fresnel_auxiliary_fit();
+  const double *__restrict xs = x.data();
+  for (size_t i = 0; i < x.size(); i++) {
+    const double ax = std::abs(xs[i]);
+    double c, s, f, g;
+    fresnel_series(xs[i], c, s);
+    // clamped so the unused fit never divides by zero
+    fit.evaluate(std::max(ax, fresnel_switch), f, g);
+    const bool near = ax <= fresnel_switch;
+    a[i] = near ? c : f;
+    b[i] = near ? s : g;
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Fresnel integrals C(x) and S(x), the integrals of cos(pi t^2 / 2)
+ * and sin(pi t^2 / 2) from 0 to x
+ *
+ * Accurate to about 1e-15 for any x.
+ */
+inline void fresnel(double x, double &c, double &s) {
+  const double ax = std::abs(x);
+  if (ax <= detail::fresnel_switch) {
+    detail::fresnel_series(x, c, s);
+    return;
+  }
+
+  double f, g;
+  detail::fresnel_auxiliary_fit().evaluate(ax, f, g);
+  const double phase = std::numbers::pi / 2 * ax * ax;
+  const double sin = std::sin(phase), cos = std::cos(phase);
+  c = std::copysign(0.5 + f * sin - g * cos, x);
+  s = std::copysign(0.5 - f * cos - g * sin, x);
+}
+
+/**
+ * @brief Fresnel integrals at every x
+ *
+ * The first pass is detail::fresnel_parts_batch, which vectorizes. The
+ * second only adds the phase terms of the elements past fresnel_switch.
+ *
+ * @param x arguments
+ * @param c filled with C(x), x.size() elements
+ * @param s filled with S(x), x.size() elements
+ */
+inline void fresnel_batch(std::span<const double> x, double *__restrict c,
+                          double *__restrict s) {
+  detail::fresnel_parts_batch(x, c, s);
+  for (size_t i = 0; i < x.size(); i++) {
+    const double ax = std::abs(x[i]);
+    if (ax <= detail::fresnel_switch)
+      continue;
+    const double f = c[i], g = s[i];
+    const double phase = std::numbers::pi / 2 * ax * ax;
+    const double sin = std::sin(phase), cos = std::cos(phase);
+    c[i] = std::copysign(0.5 + f * sin - g * cos, x[i]);
+    s[i] = std::copysign(0.5 - f * cos - g * sin, x[i]);
+  }
+}
+
+} // namespace geometry
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "../utils.h"
+#include <array>
+#include <span>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief control points of a C2 cubic spline through waypoints
+ *
+ * Builds the natural cubic spline (zero curvature at both ends) passing
+ * through every waypoint, as one set of bezier control points per pair of
+ * neighbouring waypoints. Matching first and second derivatives at every
+ * interior waypoint gives a tridiagonal system in the first control point
+ * of each segment, which is solved with the Thomas algorithm in O(N).
+ *
+ * Each result can be passed to the CubicBezier constructor, or added to the
+ * field with the pooled elementManager->addBezier(controls, {}).
+ *
+ * @param waypoints points to pass through, in order
+ * @return controls of waypoints.size() - 1 segments, empty for fewer than 2
+ * waypoints
+ */
+inline std::vector<std::array<Point, 4>>
+interpolate(std::span<const Point> waypoints) {
+  std::vector<std::array<Point, 4>> segments;
+  if (waypoints.size() < 2)
+    return segments;
+  const size_t n = waypoints.size() - 1;
+
+  // a single natural segment is a straight line
+  if (n == 1) {
+    const Point &start = waypoints[0], &end = waypoints[1];
+    segments.push_back({start, start + (end - start) / 3.0,
+                        end - (end - start) / 3.0, end});
+    return segments;
+  }
+
+  // solved in raw meters, the scratch arrays are the modified super diagonal
+  // and the first control points (right hand side until back substitution)
+  std::vector<double> super(n);
+  std::vector<double> x(n), y(n);
+  auto kx = [&waypoints](size_t i) { return waypoints[i].x.internal(); };
+  auto ky = [&waypoints](size_t i) { return waypoints[i].y.internal(); };
+
+  // rows are  2 P1_0 + P1_1 = K_0 + 2 K_1,
+  //           P1_(i-1) + 4 P1_i + P1_(i+1) = 4 K_i + 2 K_(i+1),
+  //           2 P1_(n-2) + 7 P1_(n-1) = 8 K_(n-1) + K_n
+  for (size_t i = 0; i < n; i++) {
+    double lower = 1, diagonal = 4, upper = 1;
+    double rx = 4 * kx(i) + 2 * kx(i + 1);
+    double ry = 4 * ky(i) + 2 * ky(i + 1);
+    if (i == 0) {
+      lower = 0;
+      diagonal = 2;
+      rx = kx(0) + 2 * kx(1);
+      ry = ky(0) + 2 * ky(1);
+    }
+    if (i == n - 1) {
+      lower = 2;
+      diagonal = 7;
+      upper = 0;
+      rx = 8 * kx(i) + kx(i + 1);
+      ry = 8 * ky(i) + ky(i + 1);
+    }
+
+    // forward elimination
+    if (i > 0) {
+      diagonal -= lower * super[i - 1];
+      rx -= lower * x[i - 1];
+      ry -= lower * y[i - 1];
+    }
+    super[i] = upper / diagonal;
+    x[i] = rx / diagonal;
+    y[i] = ry / diagonal;
+  }
+
+  // back substitution
+  for (size_t i = n - 1; i-- > 0;) {
+    x[i] -= super[i] * x[i + 1];
+    y[i] -= super[i] * y[i + 1];
+  }
+
+  segments.resize(n);
+  for (size_t i = 0; i < n; i++) {
+    // the second control point mirrors the next segment's first one, the
+    // last segment has zero curvature at its end instead
+    const double x2 =
+        i + 1 < n ? 2 * kx(i + 1) - x[i + 1] : (kx(n) + x[i]) / 2;
+    const double y2 =
+        i + 1 < n ? 2 * ky(i + 1) - y[i + 1] : (ky(n) + y[i]) / 2;
+    segments[i] = {waypoints[i], Point(x[i] * m, y[i] * m),
+                   Point(x2 * m, y2 * m), waypoints[i + 1]};
+  }
+  return segments;
+}
+
+} // namespace geometry
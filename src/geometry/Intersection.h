@@ -0,0 +1,594 @@
+#pragma once
+
+#include "Bezier.h"
+#include "Bounds.h"
+#include "Polygon.h"
+#include "QuinticBezier.h"
+#include "Split.h"
+#include "StaticCurve.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace geometry {
+
+// point where two curves cross, or stretch along which they overlap
+template <std::floating_point Float> struct CurveIntersection {
+  // time on the first curve
+  Float t0;
+  // time on the second curve
+  Float t1;
+  typename BasicCurve<Float>::PointType point;
+  // where the overlap ends, the same as the start for a crossing
+  Float end_t0;
+  Float end_t1;
+  typename BasicCurve<Float>::PointType end_point;
+
+  // whether the curves run along each other instead of crossing
+  bool overlap() const { return end_t0 != t0 || end_t1 != t1; }
+};
+
+// point where a curve crosses a polygon edge
+template <std::floating_point Float> struct PolygonIntersection {
+  Float t;
+  // index of the edge starting at that polygon vertex
+  size_t edge;
+  typename BasicCurve<Float>::PointType point;
+};
+
+namespace detail {
+
+// curves the intersection tests work on, beziers of any degree
+template <typename C>
+concept HullCurve = StaticCurve<C> && ControlPointCurve<C>;
+
+// number of control points of a bezier type
+template <HullCurve C>
+inline constexpr size_t control_count =
+    std::tuple_size_v<decltype(std::declval<C &>().getControlPoints())>;
+
+/**
+ * @brief control polygon of a piece of a bezier curve
+ *
+ * The curve lies inside the convex hull of its control points, so the box
+ * around them bounds the piece without evaluating it.
+ *
+ * @tparam N number of control points
+ */
+template <std::floating_point Float, size_t N> struct BezierHull {
+  std::array<Float, N> x;
+  std::array<Float, N> y;
+  // time range of the piece on the original curve
+  Float t0 = 0;
+  Float t1 = 1;
+
+  BezierHull() = default;
+
+  BezierHull(const std::array<Point, N> &controls) {
+    for (size_t i = 0; i < N; i++) {
+      x[i] = controls[i].x.internal();
+      y[i] = controls[i].y.internal();
+    }
+  }
+
+  BasicBox<Float> bounds() const {
+    BasicBox<Float> box;
+    for (size_t i = 0; i < N; i++) {
+      box.expand(x[i], y[i]);
+    }
+    return box;
+  }
+
+  // whether every control point is within tolerance of the chord
+  bool flat(Float tolerance) const {
+    const Float cx = x[N - 1] - x[0];
+    const Float cy = y[N - 1] - y[0];
+    const Float chord2 = cx * cx + cy * cy;
+    for (size_t i = 1; i + 1 < N; i++) {
+      const Float dx = x[i] - x[0];
+      const Float dy = y[i] - y[0];
+      // distance to the chord, or to the start if the chord is degenerate
+      const Float error2 = chord2 > 0
+                               ? (cx * dy - cy * dx) * (cx * dy - cy * dx) /
+                                     chord2
+                               : dx * dx + dy * dy;
+      if (error2 > tolerance * tolerance)
+        return false;
+    }
+    return true;
+  }
+
+  // de Casteljau subdivision at the middle of the piece
+  std::array<BezierHull, 2> split() const {
+    std::array<BezierHull, 2> halves;
+    std::array<Float, N> px = x, py = y;
+    for (size_t level = 0; level < N; level++) {
+      halves[0].x[level] = px[0];
+      halves[0].y[level] = py[0];
+      halves[1].x[N - 1 - level] = px[N - 1 - level];
+      halves[1].y[N - 1 - level] = py[N - 1 - level];
+      for (size_t i = 0; i + 1 < N - level; i++) {
+        px[i] = (px[i] + px[i + 1]) / 2;
+        py[i] = (py[i] + py[i + 1]) / 2;
+      }
+    }
+
+    const Float tm = (t0 + t1) / 2;
+    halves[0].t0 = t0;
+    halves[0].t1 = tm;
+    halves[1].t0 = tm;
+    halves[1].t1 = t1;
+    return halves;
+  }
+};
+
+/**
+ * @brief intersection of segments p0 p1 and q0 q1
+ *
+ * Segments within tolerance of the same line overlap instead of crossing,
+ * and both ends of the shared part are returned.
+ *
+ * @param tolerance distance from a line within which a segment lies on it
+ * @param u filled with positions along p0 p1, in [0, 1]
+ * @param v filled with the matching positions along q0 q1, in [0, 1]
+ * @return 0 if the segments miss, 1 if they cross and 2 if they overlap
+ */
+template <std::floating_point Float>
+inline size_t segment_intersection(Float p0x, Float p0y, Float p1x, Float p1y,
+                                   Float q0x, Float q0y, Float q1x, Float q1y,
+                                   Float tolerance, std::array<Float, 2> &u,
+                                   std::array<Float, 2> &v) {
+  const Float rx = p1x - p0x, ry = p1y - p0y;
+  const Float sx = q1x - q0x, sy = q1y - q0y;
+  const Float qpx = q0x - p0x, qpy = q0y - p0y;
+  const Float r2 = rx * rx + ry * ry, s2 = sx * sx + sy * sy;
+
+  // accepts hits on the shared ends of neighbouring pieces, duplicates are
+  // merged afterwards
+  constexpr Float slack = Float(1e-6);
+
+  // distances of the shorter segment's ends from the longer one's line,
+  // scaled by the longer one's length
+  const Float length2 = std::max(r2, s2);
+  if (length2 == 0)
+    return 0;
+  const Float e0 = r2 >= s2 ? rx * qpy - ry * qpx : sx * qpy - sy * qpx;
+  const Float e1 = r2 >= s2 ? rx * (q1y - p0y) - ry * (q1x - p0x)
+                            : sx * (q0y - p1y) - sy * (q0x - p1x);
+  const Float limit = tolerance * tolerance * length2;
+  if (e0 * e0 <= limit && e1 * e1 <= limit) {
+    // on one line, positions along it by projection
+    auto along_q = [&](Float x, Float y) {
+      return s2 > 0 ? std::clamp(((x - q0x) * sx + (y - q0y) * sy) / s2,
+                                 Float(0), Float(1))
+                    : Float(0);
+    };
+    if (r2 == 0) {
+      const Float at = (-qpx * sx - qpy * sy) / s2;
+      if (at < -slack || at > 1 + slack)
+        return 0;
+      u[0] = 0;
+      v[0] = std::clamp(at, Float(0), Float(1));
+      return 1;
+    }
+
+    const Float a = (qpx * rx + qpy * ry) / r2;
+    const Float b = ((q1x - p0x) * rx + (q1y - p0y) * ry) / r2;
+    const Float lo = std::max(std::min(a, b), Float(0));
+    const Float hi = std::min(std::max(a, b), Float(1));
+    if (lo > hi + slack)
+      return 0;
+    u = {lo, std::max(lo, hi)};
+    for (size_t i = 0; i < 2; i++) {
+      v[i] = along_q(p0x + u[i] * rx, p0y + u[i] * ry);
+    }
+    return 2;
+  }
+
+  const Float denominator = rx * sy - ry * sx;
+  if (denominator == 0)
+    return 0;
+
+  u[0] = (qpx * sy - qpy * sx) / denominator;
+  v[0] = (qpx * ry - qpy * rx) / denominator;
+  return u[0] >= -slack && u[0] <= 1 + slack && v[0] >= -slack &&
+                 v[0] <= 1 + slack
+             ? 1
+             : 0;
+}
+
+/**
+ * @brief Newton's method on a(s) - b(u) = 0, starting from a chord hit
+ *
+ * Times found on the chords of flat pieces are only linear estimates, since
+ * the curves aren't parameterized by distance. A few steps put them on the
+ * curves, and are rejected if they leave the pieces' time ranges.
+ */
+template <StaticCurve A, StaticCurve B, typename Float = typename A::Scalar>
+inline void polish(A &a, B &b, Float &s, Float &u, Float s0, Float s1,
+                   Float u0, Float u1) {
+  constexpr int max_iter = 4;
+  Float ns = s, nu = u;
+  for (int i = 0; i < max_iter; i++) {
+    const auto pa = a.f(ns), pb = b.f(nu);
+    const auto da = a.df(ns), db = b.df(nu);
+    const Float ex = (pa.x - pb.x).internal(), ey = (pa.y - pb.y).internal();
+    const Float ax = da.x.internal(), ay = da.y.internal();
+    const Float bx = db.x.internal(), by = db.y.internal();
+
+    // solves [da, -db] [ds, du]^T = -e
+    const Float determinant = bx * ay - ax * by;
+    if (determinant == 0)
+      return;
+    ns -= (bx * ey - by * ex) / determinant;
+    nu -= (ax * ey - ay * ex) / determinant;
+    if (!(ns >= s0 && ns <= s1 && nu >= u0 && nu <= u1))
+      return;
+  }
+  s = ns;
+  u = nu;
+}
+
+template <StaticCurve A, StaticCurve B, size_t N, size_t M>
+struct CurveIntersector {
+  using Float = typename A::Scalar;
+  using Hull0 = BezierHull<Float, N>;
+  using Hull1 = BezierHull<Float, M>;
+
+  A &curve_a;
+  B &curve_b;
+  Float tolerance;
+  std::vector<CurveIntersection<Float>> &out;
+  // stop at the first intersection
+  bool any = false;
+
+  static constexpr int max_depth = 32;
+
+  // returns true once searching can stop
+  bool intersect(const Hull0 &a, const Hull1 &b, int depth) {
+    if (!a.bounds().padded(tolerance).intersects(b.bounds()))
+      return false;
+
+    const bool a_flat = a.flat(tolerance);
+    const bool b_flat = b.flat(tolerance);
+    if ((a_flat && b_flat) || depth >= max_depth) {
+      std::array<Float, 2> u, v;
+      const size_t count = segment_intersection(
+          a.x[0], a.y[0], a.x[N - 1], a.y[N - 1], b.x[0], b.y[0], b.x[M - 1],
+          b.y[M - 1], tolerance, u, v);
+      if (count == 0)
+        return false;
+
+      std::array<Float, 2> s, t;
+      for (size_t i = 0; i < count; i++) {
+        s[i] = a.t0 + (a.t1 - a.t0) * std::clamp(u[i], Float(0), Float(1));
+        t[i] = b.t0 + (b.t1 - b.t0) * std::clamp(v[i], Float(0), Float(1));
+      }
+      if (count == 1) {
+        // allowed to move into the neighbouring pieces, duplicates are
+        // merged afterwards
+        polish(curve_a, curve_b, s[0], t[0],
+               std::max(2 * a.t0 - a.t1, Float(0)),
+               std::min(2 * a.t1 - a.t0, Float(1)),
+               std::max(2 * b.t0 - b.t1, Float(0)),
+               std::min(2 * b.t1 - b.t0, Float(1)));
+        s[1] = s[0];
+        t[1] = t[0];
+      }
+      const auto start = curve_a.f(s[0]);
+      out.push_back(
+          {s[0], t[0], start, s[1], t[1], count == 1 ? start : curve_a.f(s[1])});
+      return any;
+    }
+
+    // splits the piece that is further from flat
+    const BasicBox<Float> box_a = a.bounds(), box_b = b.bounds();
+    const bool split_a =
+        !a_flat && (b_flat || box_a.width() + box_a.height() >=
+                                  box_b.width() + box_b.height());
+    if (split_a) {
+      const auto halves = a.split();
+      return intersect(halves[0], b, depth + 1) ||
+             intersect(halves[1], b, depth + 1);
+    }
+    const auto halves = b.split();
+    return intersect(a, halves[0], depth + 1) ||
+           intersect(a, halves[1], depth + 1);
+  }
+};
+
+// Newton's method on the signed distance from a curve to the line p0 p1
+template <StaticCurve C, typename Float = typename C::Scalar>
+inline void polish_on_line(C &curve, Float &t, Float p0x, Float p0y, Float p1x,
+                           Float p1y) {
+  constexpr int max_iter = 4;
+  const Float nx = p0y - p1y, ny = p1x - p0x;
+  Float nt = t;
+  for (int i = 0; i < max_iter; i++) {
+    const auto p = curve.f(nt);
+    const auto d = curve.df(nt);
+    const Float distance =
+        (p.x.internal() - p0x) * nx + (p.y.internal() - p0y) * ny;
+    const Float slope = d.x.internal() * nx + d.y.internal() * ny;
+    if (slope == 0)
+      return;
+    nt -= distance / slope;
+    if (!(nt >= 0 && nt <= 1))
+      return;
+  }
+  t = nt;
+}
+
+// merges hits reported on both sides of a split, sorted by time on the curve.
+// Hits at the same point but far apart in time (a curve crossing itself
+// there) are kept
+template <typename Hit, typename F, typename G>
+inline void merge_duplicates(std::vector<Hit> &hits, double tolerance,
+                             F &&time, G &&close_in_time) {
+  std::sort(hits.begin(), hits.end(),
+            [&](const Hit &a, const Hit &b) { return time(a) < time(b); });
+  const double tolerance2 = tolerance * tolerance;
+  auto last =
+      std::unique(hits.begin(), hits.end(), [&](const Hit &a, const Hit &b) {
+        const double dx = (a.point.x - b.point.x).internal();
+        const double dy = (a.point.y - b.point.y).internal();
+        return dx * dx + dy * dy <= tolerance2 && close_in_time(a, b);
+      });
+  hits.erase(last, hits.end());
+}
+
+// time difference below which hits at the same point are duplicates
+inline constexpr double duplicate_time = 1e-2;
+
+/**
+ * @brief joins the overlaps found between pairs of pieces into one per
+ * stretch the curves share
+ *
+ * Neighbouring pieces report overlaps that meet end to end, and crossings
+ * where their chords touch. Both are folded into the overlap they continue.
+ *
+ * @param hits intersections sorted by time on the first curve
+ */
+template <std::floating_point Float>
+inline void merge_overlaps(std::vector<CurveIntersection<Float>> &hits) {
+  // whether b starts within the stretch of a, on both curves
+  auto continues = [](const CurveIntersection<Float> &a,
+                      const CurveIntersection<Float> &b) {
+    const Float slack = Float(duplicate_time);
+    return b.t0 <= std::max(a.t0, a.end_t0) + slack &&
+           b.t1 >= std::min(a.t1, a.end_t1) - slack &&
+           b.t1 <= std::max(a.t1, a.end_t1) + slack;
+  };
+
+  std::vector<CurveIntersection<Float>> merged;
+  for (const CurveIntersection<Float> &hit : hits) {
+    if (merged.empty() || !(merged.back().overlap() || hit.overlap()) ||
+        !(continues(merged.back(), hit) || continues(hit, merged.back()))) {
+      merged.push_back(hit);
+      continue;
+    }
+
+    // a crossing where an overlap starts becomes its start
+    CurveIntersection<Float> &last = merged.back();
+    if (!last.overlap() || hit.end_t0 > last.end_t0) {
+      last.end_t0 = hit.end_t0;
+      last.end_t1 = hit.end_t1;
+      last.end_point = hit.end_point;
+    }
+  }
+  hits = std::move(merged);
+}
+
+/**
+ * @brief crossings of a bezier with the edges of a polygon, unmerged
+ *
+ * @param curve curve to test
+ * @param polygon polygon to test, at least two points
+ * @param tolerance distance from the curve at which hits are reported
+ * @param out filled with the hits, a hit on a vertex once per edge
+ * @param any stop at the first hit
+ * @return whether any hit was found
+ */
+template <HullCurve C, typename Float = typename C::Scalar>
+bool polygon_intersections(C &curve, const BasicPolygon<Float> &polygon,
+                           Float tolerance,
+                           std::vector<PolygonIntersection<Float>> &out,
+                           bool any) {
+  constexpr size_t N = control_count<C>;
+  using Hull = BezierHull<Float, N>;
+  constexpr int max_depth = 32;
+
+  const size_t n = polygon.size();
+  const BasicBox<Float> polygon_box = polygon.bounds().padded(tolerance);
+  const auto &px = polygon.points.x;
+  const auto &py = polygon.points.y;
+
+  // explicit stack of pieces left to check
+  std::vector<std::pair<Hull, int>> stack{{Hull(curve.getControlPoints()), 0}};
+  while (!stack.empty()) {
+    const auto [piece, depth] = stack.back();
+    stack.pop_back();
+    const BasicBox<Float> box = piece.bounds();
+    if (!box.intersects(polygon_box))
+      continue;
+
+    if (depth < max_depth && !piece.flat(tolerance)) {
+      const auto halves = piece.split();
+      // the first half is visited first
+      stack.push_back({halves[1], depth + 1});
+      stack.push_back({halves[0], depth + 1});
+      continue;
+    }
+
+    bool found = false;
+    for (size_t i = 0; i < n; i++) {
+      const size_t j = i + 1 == n ? 0 : i + 1;
+      std::array<Float, 2> u, v;
+      const size_t count = segment_intersection(
+          piece.x[0], piece.y[0], piece.x[N - 1], piece.y[N - 1], px[i], py[i],
+          px[j], py[j], tolerance, u, v);
+      for (size_t k = 0; k < count; k++) {
+        Float t = piece.t0 + (piece.t1 - piece.t0) *
+                                 std::clamp(u[k], Float(0), Float(1));
+        // the ends of a piece lying along an edge are already on it
+        if (count == 1)
+          polish_on_line(curve, t, px[i], py[i], px[j], py[j]);
+        out.push_back({t, i, curve.f(t)});
+        found = true;
+      }
+    }
+    if (found && any)
+      return true;
+  }
+  return !out.empty();
+}
+
+} // namespace detail
+
+/**
+ * @brief finds the points where two beziers cross
+ *
+ * Both curves are subdivided with de Casteljau's algorithm, discarding pairs
+ * of pieces whose control point boxes don't overlap, until both pieces are
+ * within tolerance of their chords. The chords are then intersected. Most
+ * pairs of unrelated curves are rejected by the first box test.
+ *
+ * Curves that run along each other, like two routes sharing a straight, are
+ * reported as one overlap per shared stretch, from where they meet to where
+ * they part.
+ *
+ * Works on beziers of any degree, e.g. a cubic against a quintic. Curves
+ * behind the Curve interface have to be cast to their bezier type first.
+ *
+ * @param a first curve
+ * @param b second curve, with the same scalar type
+ * @param tolerance distance from the curves at which hits are reported
+ * @return intersections ordered by time on the first curve
+ */
+template <detail::HullCurve A, detail::HullCurve B,
+          typename Float = typename A::Scalar>
+  requires std::same_as<Float, typename B::Scalar>
+std::vector<CurveIntersection<Float>>
+intersections(A &a, B &b,
+              typename A::LengthType tolerance =
+                  typename A::LengthType(1e-4)) {
+  constexpr size_t N = detail::control_count<A>, M = detail::control_count<B>;
+  std::vector<CurveIntersection<Float>> result;
+  const Float tol = std::max(tolerance.internal(), Float(1e-7));
+  detail::CurveIntersector<A, B, N, M> intersector{a, b, tol, result};
+  intersector.intersect(detail::BezierHull<Float, N>(a.getControlPoints()),
+                        detail::BezierHull<Float, M>(b.getControlPoints()), 0);
+
+  detail::merge_duplicates(
+      result, 2 * tol, [](const auto &hit) { return hit.t0; },
+      [](const auto &a, const auto &b) {
+        return !a.overlap() && !b.overlap() &&
+               std::abs(a.t0 - b.t0) < detail::duplicate_time &&
+               std::abs(a.t1 - b.t1) < detail::duplicate_time;
+      });
+  detail::merge_overlaps(result);
+  return result;
+}
+
+/**
+ * @brief whether two beziers cross, stopping at the first intersection
+ *
+ * @param a first curve
+ * @param b second curve, with the same scalar type
+ * @param tolerance distance from the curves at which hits are reported
+ */
+template <detail::HullCurve A, detail::HullCurve B,
+          typename Float = typename A::Scalar>
+  requires std::same_as<Float, typename B::Scalar>
+bool intersects(A &a, B &b,
+                typename A::LengthType tolerance =
+                    typename A::LengthType(1e-4)) {
+  constexpr size_t N = detail::control_count<A>, M = detail::control_count<B>;
+  std::vector<CurveIntersection<Float>> result;
+  const Float tol = std::max(tolerance.internal(), Float(1e-7));
+  detail::CurveIntersector<A, B, N, M> intersector{a, b, tol, result, true};
+  return intersector.intersect(
+      detail::BezierHull<Float, N>(a.getControlPoints()),
+      detail::BezierHull<Float, M>(b.getControlPoints()), 0);
+}
+
+/**
+ * @brief finds the points where a bezier crosses the edges of a polygon
+ *
+ * The curve is subdivided until its pieces are flat, skipping pieces whose
+ * control point box misses the polygon's box, and each flat piece is
+ * intersected with the polygon edges. The polygon doesn't need to be convex.
+ * A curve running along an edge is hit where it joins and leaves the edge.
+ *
+ * @param curve bezier of any degree to test
+ * @param polygon polygon to test. Two points are a single segment, fewer
+ * never hit
+ * @param tolerance distance from the curve at which hits are reported
+ * @return intersections ordered by time on the curve
+ */
+template <detail::HullCurve C, typename Float = typename C::Scalar>
+std::vector<PolygonIntersection<Float>>
+intersections(C &curve, const BasicPolygon<Float> &polygon,
+              typename C::LengthType tolerance =
+                  typename C::LengthType(1e-4)) {
+  std::vector<PolygonIntersection<Float>> result;
+  if (polygon.size() < 2)
+    return result;
+
+  const Float tol = std::max(tolerance.internal(), Float(1e-7));
+  detail::polygon_intersections(curve, polygon, tol, result, false);
+
+  // a hit on a polygon vertex is reported by both of its edges
+  detail::merge_duplicates(
+      result, 2 * tol, [](const auto &hit) { return hit.t; },
+      [](const auto &a, const auto &b) {
+        return std::abs(a.t - b.t) < detail::duplicate_time;
+      });
+  return result;
+}
+
+/**
+ * @brief whether a bezier touches a polygon, by crossing it or lying inside
+ *
+ * Stops at the first hit on an edge.
+ *
+ * @param curve bezier of any degree to test
+ * @param polygon polygon to test. Two points are a single segment, which has
+ * no inside and is only touched by crossing it, as in intersections()
+ * @param tolerance distance from the curve at which hits are reported
+ */
+template <detail::HullCurve C, typename Float = typename C::Scalar>
+bool intersects(C &curve, const BasicPolygon<Float> &polygon,
+                typename C::LengthType tolerance =
+                    typename C::LengthType(1e-4)) {
+  const size_t n = polygon.size();
+  const Float tol = std::max(tolerance.internal(), Float(1e-7));
+  // padded like the boxes in intersections(), so grazing curves get through
+  if (n < 2 || !curve.bounds().intersects(polygon.bounds().padded(tol)))
+    return false;
+
+  // a curve that doesn't cross the edges is either fully inside or outside,
+  // so checking its start with an even-odd ray cast is enough. The two edges
+  // of a segment cancel, so it never counts as inside
+  const Point start = curve.endpoints[0];
+  const Float sx = start.x.internal(), sy = start.y.internal();
+  const auto &px = polygon.points.x;
+  const auto &py = polygon.points.y;
+  bool inside = false;
+  for (size_t i = 0, j = n - 1; i < n; j = i++) {
+    if ((py[i] > sy) != (py[j] > sy) &&
+        sx < (px[j] - px[i]) * (sy - py[i]) / (py[j] - py[i]) + px[i])
+      inside = !inside;
+  }
+  if (inside)
+    return true;
+
+  std::vector<PolygonIntersection<Float>> hits;
+  return detail::polygon_intersections(curve, polygon, tol, hits, true);
+}
+
+} // namespace geometry
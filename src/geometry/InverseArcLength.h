@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Curve.h"
+#include "CurveAnalysis.h"
+#include "StaticCurve.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief fits a Chebyshev series of the given degree to a curve's t(s)
+ *
+ * Solves t_by_s once at each Chebyshev node, then checks the fit by
+ * measuring how far s(t(s)) lands from s on a grid several times denser
+ * than the nodes.
+ *
+ * @param curve curve to approximate
+ * @param degree degree of the series
+ */
+template <StaticCurve C>
+BasicInverseArcLength<typename C::Scalar>
+fit_inverse_arc_length(C &curve, size_t degree) {
+  using Float = typename C::Scalar;
+  using LengthType = typename C::LengthType;
+
+  BasicInverseArcLength<Float> fit;
+  fit.length = curve.s(Float(1)).internal();
+  const size_t n = degree + 1;
+  fit.coefficients.assign(n, 0);
+  if (fit.length <= 0)
+    return fit;
+
+  // t at the nodes x_k = cos(pi (k + 1/2) / n), mapped to [0, length]
+  std::vector<double> angles(n), times(n);
+  for (size_t k = 0; k < n; k++) {
+    angles[k] = std::numbers::pi * (k + 0.5) / n;
+    const double s = (std::cos(angles[k]) + 1) / 2 * fit.length;
+    times[k] = curve.t_by_s(LengthType(s * m));
+  }
+
+  // discrete Chebyshev transform, in double so low degree coefficients
+  // don't lose the small high degree ones
+  for (size_t j = 0; j < n; j++) {
+    double sum = 0;
+    for (size_t k = 0; k < n; k++) {
+      sum += times[k] * std::cos(j * angles[k]);
+    }
+    fit.coefficients[j] = Float(sum * 2 / n);
+  }
+  fit.coefficients[0] /= 2;
+
+  const size_t checks = std::max<size_t>(64, 4 * n);
+  for (size_t i = 0; i <= checks; i++) {
+    const Float s = fit.length * i / checks;
+    const Float error = curve.s(fit.t(s)).internal() - s;
+    fit.max_error = std::max(fit.max_error, std::abs(error));
+  }
+  return fit;
+}
+
+/**
+ * @brief fits the lowest degree Chebyshev series of t(s) within tolerance
+ *
+ * Tries degrees 7, 15, 31 and 63 in turn. Where the curve stops (e.g. a
+ * control point on an endpoint) t(s) behaves like a square root and no low
+ * degree fits well; the highest degree fit is returned then, and its
+ * max_error tells how far off it is.
+ *
+ * @param curve curve to approximate
+ * @param tolerance allowed distance between s and s(t(s))
+ */
+template <StaticCurve C>
+BasicInverseArcLength<typename C::Scalar>
+fit_inverse_arc_length(C &curve, typename C::LengthType tolerance) {
+  constexpr size_t max_degree = 63;
+  BasicInverseArcLength<typename C::Scalar> fit;
+  for (size_t degree = 7; degree <= max_degree; degree = 2 * degree + 1) {
+    fit = fit_inverse_arc_length(curve, degree);
+    if (fit.max_error <= tolerance.internal())
+      break;
+  }
+  return fit;
+}
+
+/**
+ * @brief returns the curve's cached Chebyshev fit of t(s), fitting if needed
+ *
+ * Fitted to within a hundredth of an inch, the tolerance of t_by_s, on the
+ * first call after the curve changed.
+ *
+ * @param curve curve to approximate
+ */
+template <std::floating_point Float>
+const BasicInverseArcLength<Float> &
+inverse_arc_length(BasicCurve<Float> &curve) {
+  return curve.inverseArcLengthCache().get(curve.version(), [&curve] {
+    return fit_inverse_arc_length(
+        curve, typename BasicCurve<Float>::LengthType(in * 1e-2));
+  });
+}
+
+} // namespace geometry
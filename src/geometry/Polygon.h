@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Bounds.h"
+#include "Samples.h"
+#include <concepts>
+
+namespace geometry {
+
+/**
+ * @brief closed polygon, e.g. a game element or field obstacle
+ *
+ * Vertices are stored like a batch of samples, in internal units and in
+ * either winding order. The last vertex connects back to the first.
+ * Separating axis tests assume the polygon is convex, concave obstacles
+ * should be split into convex parts.
+ */
+template <std::floating_point Float> struct BasicPolygon {
+  BasicCurveSamples<Float> points;
+
+  size_t size() const { return points.size(); }
+
+  void push_back(Float x, Float y) {
+    points.x.push_back(x);
+    points.y.push_back(y);
+  }
+
+  void push_back(Point point) {
+    push_back(point.x.internal(), point.y.internal());
+  }
+
+  BasicBox<Float> bounds() const {
+    BasicBox<Float> box;
+    for (size_t i = 0; i < size(); i++) {
+      box.expand(points.x[i], points.y[i]);
+    }
+    return box;
+  }
+};
+
+using Polygon = BasicPolygon<float>;
+using DPolygon = BasicPolygon<double>;
+
+} // namespace geometry
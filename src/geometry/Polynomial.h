@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <utility>
+
+namespace geometry {
+
+/**
+ * @brief real roots of a t^2 + b t + c = 0
+ *
+ * Degenerates to the linear case when a is (nearly) zero. Uses the
+ * numerically stable form that avoids subtracting nearly equal values.
+ *
+ * @param roots filled with the roots, in no particular order
+ * @return number of roots written
+ */
+template <std::floating_point Float>
+inline size_t solve_quadratic(Float a, Float b, Float c,
+                              std::array<Float, 2> &roots) {
+  const Float scale = std::abs(a) + std::abs(b) + std::abs(c);
+  if (scale == 0)
+    return 0;
+
+  if (std::abs(a) <= scale * Float(1e-7)) {
+    if (std::abs(b) <= scale * Float(1e-7))
+      return 0;
+    roots[0] = -c / b;
+    return 1;
+  }
+
+  const Float discriminant = b * b - 4 * a * c;
+  if (discriminant < 0)
+    return 0;
+
+  const Float q = -(b + std::copysign(std::sqrt(discriminant), b)) / 2;
+  roots[0] = q / a;
+  if (q == 0)
+    return 1;
+  roots[1] = c / q;
+  return 2;
+}
+
+/**
+ * @brief evaluates a polynomial, coefficients ordered highest degree first
+ */
+template <std::floating_point Float, size_t N>
+inline Float horner(const std::array<Float, N> &coeffs, Float t) {
+  Float result = coeffs[0];
+  for (size_t i = 1; i < N; i++) {
+    result = result * t + coeffs[i];
+  }
+  return result;
+}
+
+/**
+ * @brief real roots of a polynomial between lo and hi
+ *
+ * The roots of the derivative split the interval into pieces on which the
+ * polynomial is monotone, and every piece whose ends differ in sign is
+ * bisected down to the last bit. Works for any degree; roots where the
+ * polynomial only touches zero without changing sign may be missed.
+ *
+ * @param coeffs coefficients, highest degree first
+ * @param lo start of the interval
+ * @param hi end of the interval
+ * @param roots filled with the roots, in increasing order
+ * @return number of roots written
+ */
+template <std::floating_point Float, size_t N>
+inline size_t solve_polynomial(const std::array<Float, N> &coeffs, Float lo,
+                               Float hi, std::array<Float, N - 1> &roots) {
+  static_assert(N >= 2, "polynomial needs to be at least linear");
+
+  if constexpr (N <= 3) {
+    std::array<Float, 2> all;
+    const size_t count =
+        N == 2 ? solve_quadratic(Float(0), coeffs[0], coeffs[N - 1], all)
+               : solve_quadratic(coeffs[0], coeffs[1], coeffs[N - 1], all);
+    size_t found = 0;
+    for (size_t i = 0; i < count; i++) {
+      if (all[i] >= lo && all[i] <= hi)
+        roots[found++] = all[i];
+    }
+    if (found == 2 && roots[1] < roots[0])
+      std::swap(roots[0], roots[1]);
+    return found;
+  } else {
+    std::array<Float, N - 1> derivative;
+    for (size_t i = 0; i + 1 < N; i++) {
+      derivative[i] = coeffs[i] * Float(N - 1 - i);
+    }
+    std::array<Float, N - 2> critical;
+    const size_t pieces = solve_polynomial(derivative, lo, hi, critical) + 1;
+
+    size_t found = 0;
+    Float a = lo, fa = horner(coeffs, lo);
+    for (size_t i = 0; i < pieces; i++) {
+      const Float b = i + 1 < pieces ? critical[i] : hi;
+      const Float fb = horner(coeffs, b);
+      if ((fa < 0) != (fb < 0)) {
+        // keeps the invariant that the root lies in [left, right]
+        Float left = a, right = b;
+        const bool rising = fa < 0;
+        for (;;) {
+          const Float middle = (left + right) / 2;
+          if (middle <= left || middle >= right)
+            break;
+          ((horner(coeffs, middle) < 0) == rising ? left : right) = middle;
+        }
+        roots[found++] = (left + right) / 2;
+      }
+      a = b;
+      fa = fb;
+    }
+    return found;
+  }
+}
+
+/**
+ * @brief coefficients of x(t)^2 + y(t)^2, ordered highest degree first
+ *
+ * With the derivative's coefficients this is the squared speed, so the speed
+ * of a polynomial curve is the square root of a single polynomial.
+ *
+ * @param x coefficients of x(t), highest degree first
+ * @param y coefficients of y(t), highest degree first
+ */
+template <std::floating_point Float, size_t N>
+inline std::array<Float, 2 * N - 1>
+squared_norm(const std::array<Float, N> &x, const std::array<Float, N> &y) {
+  std::array<Float, 2 * N - 1> result{};
+  for (size_t i = 0; i < N; i++) {
+    for (size_t j = 0; j < N; j++) {
+      result[i + j] += x[i] * x[j] + y[i] * y[j];
+    }
+  }
+  return result;
+}
+
+} // namespace geometry
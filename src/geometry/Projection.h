@@ -0,0 +1,214 @@
+#pragma once
+
+#include "SplinePath.h"
+#include "StaticCurve.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace geometry {
+
+// closest point on a curve to a query point
+template <StaticCurve C> struct Projection {
+  using Float = typename C::Scalar;
+
+  Float t;
+  typename C::PointType point;
+  typename C::LengthType distance;
+};
+
+namespace detail {
+
+// squared distance between the curve at t and the target, in internal units
+template <StaticCurve C>
+inline auto distance2(C &curve, typename C::Scalar t,
+                      typename C::Scalar x, typename C::Scalar y) {
+  const auto p = curve.f(t);
+  const auto dx = p.x.internal() - x;
+  const auto dy = p.y.internal() - y;
+  return dx * dx + dy * dy;
+}
+
+/**
+ * @brief Newton's method on d/dt |f(t) - target|^2 / 2, kept inside [lo, hi]
+ *
+ * Steps that leave the bracket or go uphill (the second derivative of the
+ * distance is not positive) are replaced by moving halfway to the bracket
+ * edge the gradient points to.
+ */
+template <StaticCurve C>
+inline typename C::Scalar refine(C &curve, typename C::Scalar t,
+                                 typename C::Scalar lo, typename C::Scalar hi,
+                                 typename C::Scalar x, typename C::Scalar y) {
+  using Float = typename C::Scalar;
+  constexpr int max_iter = 8;
+  constexpr Float tol = std::numeric_limits<Float>::epsilon() * 4;
+
+  for (int i = 0; i < max_iter; i++) {
+    const auto p = curve.f(t);
+    const auto d = curve.df(t);
+    const auto dd = curve.ddf(t);
+
+    const Float ex = p.x.internal() - x;
+    const Float ey = p.y.internal() - y;
+    const Float dx = d.x.internal();
+    const Float dy = d.y.internal();
+
+    // gradient and curvature of the squared distance
+    const Float g = ex * dx + ey * dy;
+    const Float h = dx * dx + dy * dy + ex * dd.x.internal() +
+                    ey * dd.y.internal();
+
+    Float next = h > 0 ? t - g / h : std::numeric_limits<Float>::quiet_NaN();
+    if (!(next > lo && next < hi))
+      next = g > 0 ? (t + lo) / 2 : (t + hi) / 2;
+
+    if (std::abs(next - t) <= tol)
+      return next;
+    t = next;
+  }
+  return t;
+}
+
+} // namespace detail
+
+/**
+ * @brief finds the point on a curve closest to a target
+ *
+ * Without a hint the curve is sampled coarsely, and Newton's method refines
+ * each locally closest sample within its neighbouring samples before the
+ * results are compared to the curve ends. With a hint (e.g. the result of the
+ * previous query when tracking a robot along a path), Newton starts from the
+ * hint directly and the coarse pass is skipped, returning the local minimum
+ * nearest the hint.
+ *
+ * @param curve curve to project on
+ * @param target point to project
+ * @param hint time near the expected result
+ * @return time, point and distance of the closest point
+ */
+template <StaticCurve C>
+Projection<C> project(C &curve, Point target,
+                      std::optional<typename C::Scalar> hint = {}) {
+  using Float = typename C::Scalar;
+  using LengthType = typename C::LengthType;
+
+  const Float x = target.x.internal();
+  const Float y = target.y.internal();
+
+  Float best_t;
+  if (hint) {
+    best_t = detail::refine(curve, std::clamp(*hint, Float(0), Float(1)),
+                            Float(0), Float(1), x, y);
+  } else {
+    constexpr size_t samples = 16;
+    std::array<Float, samples + 1> d2;
+    for (size_t i = 0; i <= samples; i++) {
+      d2[i] = detail::distance2(curve, Float(i) / samples, x, y);
+    }
+
+    // refine every local minimum of the samples, the smallest sample alone
+    // picks the wrong basin when two parts of the curve are almost as close
+    best_t = 0;
+    Float best_d2 = std::numeric_limits<Float>::infinity();
+    for (size_t i = 0; i <= samples; i++) {
+      if ((i > 0 && d2[i - 1] < d2[i]) || (i < samples && d2[i + 1] < d2[i]))
+        continue;
+
+      const Float lo = Float(i == 0 ? 0 : i - 1) / samples;
+      const Float hi = Float(std::min(i + 1, samples)) / samples;
+      const Float t = detail::refine(curve, Float(i) / samples, lo, hi, x, y);
+      const Float refined = detail::distance2(curve, t, x, y);
+      if (refined < best_d2) {
+        best_d2 = refined;
+        best_t = t;
+      }
+    }
+  }
+
+  // the minimum can also be at either end of the curve
+  Float best_d2 = detail::distance2(curve, best_t, x, y);
+  for (Float end : {Float(0), Float(1)}) {
+    const Float d2 = detail::distance2(curve, end, x, y);
+    if (d2 < best_d2) {
+      best_d2 = d2;
+      best_t = end;
+    }
+  }
+
+  return {best_t, curve.f(best_t), LengthType(std::sqrt(best_d2))};
+}
+
+// closest point on a spline path to a query point
+template <std::floating_point Float> struct PathProjection {
+  typename BasicSplinePath<Float>::Location location;
+  typename BasicCurve<Float>::PointType point;
+  typename BasicCurve<Float>::LengthType distance;
+};
+
+/**
+ * @brief finds the point on a spline path closest to a target
+ *
+ * Segments are visited in order of the distance from the target to their
+ * bounds, and skipped once that distance exceeds the best match so far. With
+ * a hint only the hinted segment is refined (and its neighbour when the
+ * result lies on a join), tracking the local minimum like the curve overload.
+ *
+ * @param path path to project on
+ * @param target point to project
+ * @param hint location near the expected result
+ * @return location, point and distance of the closest point
+ */
+template <std::floating_point Float>
+PathProjection<Float>
+project(BasicSplinePath<Float> &path, Point target,
+        std::optional<typename BasicSplinePath<Float>::Location> hint = {}) {
+  using CurveType = BasicCurve<Float>;
+  using LengthType = typename CurveType::LengthType;
+
+  PathProjection<Float> best{
+      {0, 0}, {}, LengthType(std::numeric_limits<Float>::infinity())};
+  if (path.empty())
+    return best;
+
+  auto consider = [&](size_t segment, std::optional<Float> t_hint) {
+    const Projection<CurveType> result =
+        project(path.segment(segment), target, t_hint);
+    if (result.distance < best.distance)
+      best = {{segment, result.t}, result.point, result.distance};
+  };
+
+  if (hint && hint->segment < path.size()) {
+    consider(hint->segment, hint->t);
+    // the closest point moved over a join
+    if (best.location.t <= 0 && hint->segment > 0)
+      consider(hint->segment - 1, Float(1));
+    else if (best.location.t >= 1 && hint->segment + 1 < path.size())
+      consider(hint->segment + 1, Float(0));
+    return best;
+  }
+
+  const Float x = target.x.internal();
+  const Float y = target.y.internal();
+
+  // lower bound of the distance to each segment
+  std::vector<std::pair<Float, size_t>> order(path.size());
+  for (size_t i = 0; i < path.size(); i++) {
+    order[i] = {path.segment(i).bounds().distance2(x, y), i};
+  }
+  std::sort(order.begin(), order.end());
+
+  for (const auto &[lower_bound2, segment] : order) {
+    const Float best_distance = best.distance.internal();
+    if (lower_bound2 > best_distance * best_distance)
+      break;
+    consider(segment, std::nullopt);
+  }
+
+  return best;
+}
+
+} // namespace geometry
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+
+namespace geometry {
+
+// how a curve integrates its speed to get arc length
+enum class IntegrationMethod {
+  // fixed 5 point Gauss-Legendre rule, cheap but no error control
+  Gauss5,
+  // adaptive 7/15 point Gauss-Kronrod, subdivides until within tolerance
+  AdaptiveGaussKronrod,
+};
+
+struct Integration {
+  IntegrationMethod method = IntegrationMethod::Gauss5;
+  // absolute error allowed over a whole curve, in meters
+  double tolerance = 1e-5;
+  // maximum number of times an interval may be bisected
+  int max_depth = 12;
+};
+
+/**
+ * @brief integrates f over [a, b] with the 5 point Gauss-Legendre rule
+ *
+ * @param f integrand, called with and returning a Float
+ * @param evaluations incremented by the number of calls to f
+ */
+template <std::floating_point Float, typename F>
+inline Float gauss_legendre_5(F &&f, Float a, Float b, size_t &evaluations) {
+  // This implementation is heavily based on vmplib:
+  // https://github.com/SerrialError/vmplib/blob/main/src/bezier.cpp
+
+  // clang-format off
+  static constexpr std::array<Float, 5> nodes = {-0.9061798459, -0.5384693101, 0.0, 0.5384693101, 0.9061798459};
+  static constexpr std::array<Float, 5> weights = {0.2369268850, 0.4786286705, 0.5688888889, 0.4786286705, 0.2369268850};
+  // clang-format on
+
+  const Float half = (b - a) / 2;
+  const Float mid = (a + b) / 2;
+  Float sum = 0;
+  for (size_t i = 0; i < nodes.size(); i++) {
+    sum += weights[i] * f(mid + half * nodes[i]);
+  }
+  evaluations += nodes.size();
+  return half * sum;
+}
+
+/**
+ * @brief integrates f over [a, b] with the 15 point Kronrod rule
+ *
+ * The embedded 7 point Gauss rule reuses every other node, and the
+ * difference between both results is returned as an error estimate.
+ *
+ * @param f integrand, called with and returning a Float
+ * @param error set to the estimated absolute error
+ * @param evaluations incremented by the number of calls to f
+ */
+template <std::floating_point Float, typename F>
+inline Float gauss_kronrod_15(F &&f, Float a, Float b, Float &error,
+                              size_t &evaluations) {
+  // abscissae and weights from QUADPACK (qk15), positive half only
+  // clang-format off
+  static constexpr std::array<double, 8> kronrod_nodes = {0.991455371120813, 0.949107912342759, 0.864864423359769, 0.741531185599394, 0.586087235467691, 0.405845151377397, 0.207784955007898, 0.0};
+  static constexpr std::array<double, 8> kronrod_weights = {0.022935322010529, 0.063092092629979, 0.104790010322250, 0.140653259715525, 0.169004726639267, 0.190350578064785, 0.204432940075298, 0.209482141084728};
+  // gauss weights for the odd kronrod nodes
+  static constexpr std::array<double, 4> gauss_weights = {0.129484966168870, 0.279705391489277, 0.381830050505119, 0.417959183673469};
+  // clang-format on
+
+  const double half = (double(b) - a) / 2.0;
+  const double mid = (double(a) + b) / 2.0;
+
+  const double center = f(Float(mid));
+  double kronrod = center * kronrod_weights[7];
+  double gauss = center * gauss_weights[3];
+
+  for (size_t i = 0; i < 7; i++) {
+    const double offset = half * kronrod_nodes[i];
+    const double pair =
+        double(f(Float(mid - offset))) + f(Float(mid + offset));
+    kronrod += kronrod_weights[i] * pair;
+    if (i % 2 == 1)
+      gauss += gauss_weights[i / 2] * pair;
+  }
+  evaluations += 15;
+
+  error = Float(std::abs((kronrod - gauss) * half));
+  return Float(kronrod * half);
+}
+
+/**
+ * @brief adaptively integrates f over [a, b] to within tolerance
+ *
+ * Intervals whose Gauss-Kronrod error estimate exceeds their share of the
+ * tolerance are bisected, so smooth integrands cost a single 15 point rule
+ * while sharp features get refined locally.
+ *
+ * @param f integrand, called with and returning a Float
+ * @param tolerance absolute error allowed over [a, b]
+ * @param max_depth maximum number of bisections of any interval
+ * @param evaluations incremented by the number of calls to f
+ */
+template <std::floating_point Float, typename F>
+inline Float adaptive_gauss_kronrod(F &&f, Float a, Float b, Float tolerance,
+                                    int max_depth, size_t &evaluations) {
+  Float error;
+  const Float whole = gauss_kronrod_15(f, a, b, error, evaluations);
+  if (error <= tolerance || max_depth <= 0)
+    return whole;
+
+  const Float mid = (a + b) / 2;
+  return adaptive_gauss_kronrod(f, a, mid, tolerance / 2, max_depth - 1,
+                                evaluations) +
+         adaptive_gauss_kronrod(f, mid, b, tolerance / 2, max_depth - 1,
+                                evaluations);
+}
+
+/**
+ * @brief integrates f over [a, b] with the given settings
+ *
+ * @param f integrand, called with and returning a Float
+ * @param integration method and maximum subdivision depth to use
+ * @param tolerance absolute error allowed over [a, b], only used by adaptive
+ * methods
+ * @param evaluations incremented by the number of calls to f
+ */
+template <std::floating_point Float, typename F>
+inline Float integrate(F &&f, Float a, Float b, const Integration &integration,
+                       Float tolerance, size_t &evaluations) {
+  switch (integration.method) {
+  case IntegrationMethod::AdaptiveGaussKronrod:
+    return adaptive_gauss_kronrod(f, a, b, tolerance, integration.max_depth,
+                                  evaluations);
+  case IntegrationMethod::Gauss5:
+  default:
+    return gauss_legendre_5(f, a, b, evaluations);
+  }
+}
+
+} // namespace geometry
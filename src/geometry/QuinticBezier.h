@@ -0,0 +1,75 @@
+#pragma once
+
+#include "BezierBase.h"
+#include "units/Vector2D.hpp"
+#include "units/units.hpp"
+#include <array>
+
+namespace geometry {
+
+/**
+ * @brief quintic bezier curve
+ *
+ * Has enough control points to set position, first and second derivative at
+ * both ends independently, so chains of quintics can be C2 (continuous
+ * curvature) while every segment keeps its own shape. Everything but the
+ * basis is shared with CubicBezier through BasicBezier.
+ */
+template <std::floating_point Float>
+class BasicQuinticBezier final
+    : public BasicBezier<Float, 6, BasicQuinticBezier<Float>> {
+public:
+  // basis matrix, shared by every curve of this type
+  static constexpr std::array<std::array<Float, 6>, 6> basis_matrix{
+      {{-1, 5, -10, 10, -5, 1},
+       {5, -20, 30, -20, 5, 0},
+       {-10, 30, -30, 10, 0, 0},
+       {10, -20, 10, 0, 0, 0},
+       {-5, 5, 0, 0, 0, 0},
+       {1, 0, 0, 0, 0, 0}}};
+
+  BasicQuinticBezier(std::array<Point, 6> controls)
+      : BasicBezier<Float, 6, BasicQuinticBezier>(controls) {}
+
+  /**
+   * @brief quintic hermite curve between two states
+   *
+   * Derivatives are with respect to the curve's time, so a velocity of v
+   * means the curve leaves its start heading along v with speed |v| per
+   * unit of t.
+   *
+   * @param start position at t = 0
+   * @param start_velocity first derivative at t = 0
+   * @param start_acceleration second derivative at t = 0
+   * @param end position at t = 1
+   * @param end_velocity first derivative at t = 1
+   * @param end_acceleration second derivative at t = 1
+   */
+  static BasicQuinticBezier hermite(Point start, Point start_velocity,
+                                    Point start_acceleration, Point end,
+                                    Point end_velocity,
+                                    Point end_acceleration) {
+    return BasicQuinticBezier(hermiteControls(start, start_velocity,
+                                              start_acceleration, end,
+                                              end_velocity, end_acceleration));
+  }
+
+  // control points of the quintic hermite curve between two states
+  static std::array<Point, 6>
+  hermiteControls(Point start, Point start_velocity, Point start_acceleration,
+                  Point end, Point end_velocity, Point end_acceleration) {
+    return {start,
+            start + start_velocity / 5.0,
+            start + start_velocity * 0.4 + start_acceleration / 20.0,
+            end - end_velocity * 0.4 + end_acceleration / 20.0,
+            end - end_velocity / 5.0,
+            end};
+  }
+
+  ~BasicQuinticBezier() override = default;
+};
+
+using QuinticBezier = BasicQuinticBezier<float>;
+using DQuinticBezier = BasicQuinticBezier<double>;
+
+} // namespace geometry
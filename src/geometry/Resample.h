@@ -0,0 +1,136 @@
+#pragma once
+
+#include "ArcLengthCursor.h"
+#include "Samples.h"
+#include "SplinePath.h"
+#include <cmath>
+#include <concepts>
+
+namespace geometry {
+
+namespace detail {
+
+template <std::floating_point Float> struct Resampler {
+  using CurveType = BasicCurve<Float>;
+  using LengthType = typename CurveType::LengthType;
+
+  BasicPathSamples<Float> &out;
+  // distance between samples, in meters
+  Float spacing;
+  // index of the next sample, its distance is recomputed from the index so
+  // rounding doesn't build up over long paths
+  size_t next = 0;
+
+  // direction of travel at t, falling back to the second derivative where
+  // the curve stops (e.g. a control point on an endpoint)
+  static Float heading(CurveType &curve, Float t,
+                       const typename CurveType::PointType &d) {
+    Float dx = d.x.internal(), dy = d.y.internal();
+    if (std::hypot(dx, dy) < Float(1e-6)) {
+      const auto dd = curve.ddf(t);
+      const Float sign = t < Float(0.5) ? 1 : -1;
+      dx = sign * dd.x.internal();
+      dy = sign * dd.y.internal();
+    }
+    return std::atan2(dy, dx);
+  }
+
+  void emit(CurveType &curve, Float t, Float distance) {
+    const auto p = curve.f(t);
+    const auto d = curve.df(t);
+    out.push_back(distance, p.x.internal(), p.y.internal(),
+                  heading(curve, t, d), curve.c(t, d).internal());
+  }
+
+  // adds the samples on a curve that starts at offset along the path
+  void sample(CurveType &curve, Float offset) {
+    const Float end = offset + curve.total_distance().internal();
+    BasicArcLengthCursor<Float> cursor(curve);
+    for (Float distance = next * spacing; distance <= end;
+         distance = ++next * spacing) {
+      // each step only integrates the interval since the previous sample
+      const Float step = distance - offset - cursor.s().internal();
+      cursor.advance_s(LengthType(step * m));
+      emit(curve, cursor.t(), distance);
+    }
+  }
+
+  // adds the end of the path unless the last sample already landed on it
+  void finish(CurveType &curve, Float end) {
+    if (out.size() == 0 || out.s.back() < end - spacing * Float(1e-3))
+      emit(curve, 1, end);
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief samples a curve at evenly spaced distances
+ *
+ * Walks the curve once with an arc length cursor, so every sample only
+ * integrates the stretch since the previous one instead of solving t_by_s
+ * from the start of the curve.
+ *
+ * @param curve curve to sample
+ * @param spacing distance between neighbouring samples
+ * @return samples at 0, spacing, 2 spacing, ... and at the end of the curve,
+ * so the last gap may be shorter. Only the two ends for a spacing <= 0
+ */
+template <std::floating_point Float>
+BasicPathSamples<Float>
+resample(BasicCurve<Float> &curve,
+         typename BasicCurve<Float>::LengthType spacing) {
+  BasicPathSamples<Float> out;
+  const Float length = curve.total_distance().internal();
+  if (spacing.internal() <= 0) {
+    detail::Resampler<Float> resampler{out, length};
+    resampler.emit(curve, 0, 0);
+    resampler.finish(curve, length);
+    return out;
+  }
+
+  out.reserve(static_cast<size_t>(length / spacing.internal()) + 2);
+  detail::Resampler<Float> resampler{out, Float(spacing.internal())};
+  resampler.sample(curve, 0);
+  resampler.finish(curve, length);
+  return out;
+}
+
+/**
+ * @brief samples a path at evenly spaced distances
+ *
+ * The spacing runs on across joins, so samples stay evenly spaced along the
+ * whole path rather than restarting at every segment.
+ *
+ * @param path path to sample
+ * @param spacing distance between neighbouring samples
+ * @return samples at 0, spacing, 2 spacing, ... and at the end of the path,
+ * so the last gap may be shorter. Only the two ends for a spacing <= 0
+ */
+template <std::floating_point Float>
+BasicPathSamples<Float>
+resample(BasicSplinePath<Float> &path,
+         typename BasicCurve<Float>::LengthType spacing) {
+  BasicPathSamples<Float> out;
+  if (path.empty())
+    return out;
+
+  const Float length = path.total_distance().internal();
+  BasicCurve<Float> &last = path.segment(path.size() - 1);
+  if (spacing.internal() <= 0) {
+    detail::Resampler<Float> resampler{out, length};
+    resampler.emit(path.segment(0), 0, 0);
+    resampler.finish(last, length);
+    return out;
+  }
+
+  out.reserve(static_cast<size_t>(length / spacing.internal()) + 2);
+  detail::Resampler<Float> resampler{out, Float(spacing.internal())};
+  for (size_t i = 0; i < path.size(); i++) {
+    resampler.sample(path.segment(i), path.start_distance(i).internal());
+  }
+  resampler.finish(last, length);
+  return out;
+}
+
+} // namespace geometry
@@ -0,0 +1,367 @@
+#pragma once
+
+#include "../utils.h"
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <span>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief structure-of-arrays buffer of curve samples
+ *
+ * Values are stored as raw scalars in the internal (SI) unit of the sampled
+ * quantity, so a position batch holds meters and a derivative batch holds
+ * meters per unit t. Keeping x and y in separate contiguous arrays lets the
+ * batch evaluators vectorize and lets callers hand the buffers straight to
+ * renderers or exporters.
+ */
+template <std::floating_point Float> struct BasicCurveSamples {
+  std::vector<Float> x;
+  std::vector<Float> y;
+
+  void resize(size_t n) {
+    x.resize(n);
+    y.resize(n);
+  }
+
+  size_t size() const { return x.size(); }
+
+  // converts sample i back into a unit-typed point
+  Point point(size_t i) const { return Point(x[i] * m, y[i] * m); }
+};
+
+using CurveSamples = BasicCurveSamples<float>;
+using DCurveSamples = BasicCurveSamples<double>;
+
+/**
+ * @brief curve flattened to line segments
+ *
+ * Vertices are stored like a batch of samples, together with the curve time
+ * each vertex was sampled at so queries on the polyline can be refined on the
+ * curve itself.
+ */
+template <std::floating_point Float> struct BasicPolyline {
+  BasicCurveSamples<Float> points;
+  std::vector<Float> t;
+  // maximum distance between the polyline and the curve, in meters
+  Float tolerance = 0;
+
+  size_t size() const { return t.size(); }
+
+  void clear() {
+    points.x.clear();
+    points.y.clear();
+    t.clear();
+  }
+
+  void push_back(Float time, Float x, Float y) {
+    points.x.push_back(x);
+    points.y.push_back(y);
+    t.push_back(time);
+  }
+};
+
+using Polyline = BasicPolyline<float>;
+using DPolyline = BasicPolyline<double>;
+
+/**
+ * @brief poses spaced evenly along a curve or path
+ *
+ * Each sample carries what a path follower needs: position, distance from
+ * the start, heading of the tangent and signed curvature, all in internal
+ * units.
+ */
+template <std::floating_point Float> struct BasicPathSamples {
+  BasicCurveSamples<Float> points;
+  // distance from the start, in meters
+  std::vector<Float> s;
+  // direction of travel, in radians counterclockwise from the x axis
+  std::vector<Float> heading;
+  // signed curvature, in radians per meter
+  std::vector<Float> curvature;
+
+  size_t size() const { return s.size(); }
+
+  void reserve(size_t n) {
+    points.x.reserve(n);
+    points.y.reserve(n);
+    s.reserve(n);
+    heading.reserve(n);
+    curvature.reserve(n);
+  }
+
+  void push_back(Float distance, Float x, Float y, Float direction,
+                 Float k) {
+    points.x.push_back(x);
+    points.y.push_back(y);
+    s.push_back(distance);
+    heading.push_back(direction);
+    curvature.push_back(k);
+  }
+};
+
+using PathSamples = BasicPathSamples<float>;
+using DPathSamples = BasicPathSamples<double>;
+
+/**
+ * @brief evaluates a polynomial with vector coefficients at every t
+ *
+ * Coefficients are ordered from the highest power of t to the constant term,
+ * matching the layout of the bezier coefficient matrices. The inner loop has
+ * no dependencies between samples, so the compiler can vectorize it.
+ *
+ * @param coeffs polynomial coefficients, highest degree first
+ * @param t sample times
+ * @param x output x values, must hold t.size() scalars
+ * @param y output y values, must hold t.size() scalars
+ */
+template <std::floating_point Float, typename Vector, size_t N>
+inline void horner_batch(const std::array<Vector, N> &coeffs,
+                         std::span<const Float> t, Float *__restrict x,
+                         Float *__restrict y) {
+  static_assert(N > 0, "polynomial needs at least one coefficient");
+
+  // unit-typed coefficients are unpacked once so the loop only sees scalars
+  std::array<Float, N> cx, cy;
+  for (size_t j = 0; j < N; j++) {
+    cx[j] = coeffs[j].x.internal();
+    cy[j] = coeffs[j].y.internal();
+  }
+
+  const Float *__restrict ts = t.data();
+  const size_t n = t.size();
+  for (size_t i = 0; i < n; i++) {
+    const Float ti = ts[i];
+    Float rx = cx[0];
+    Float ry = cy[0];
+    // unrolled so the compiler vectorizes across samples, not coefficients
+#pragma GCC unroll 8
+    for (size_t j = 1; j < N; j++) {
+      rx = rx * ti + cx[j];
+      ry = ry * ti + cy[j];
+    }
+    x[i] = rx;
+    y[i] = ry;
+  }
+}
+
+namespace detail {
+
+// T(k, j) = j! S(k, j), the j-th forward difference of u^k at u = 0, with
+// T(k, j) = j (T(k - 1, j) + T(k - 1, j - 1))
+template <std::floating_point Float, size_t N>
+constexpr std::array<std::array<Float, N>, N> surjection_table() {
+  std::array<std::array<Float, N>, N> table{};
+  table[0][0] = 1;
+  for (size_t k = 1; k < N; k++) {
+    for (size_t j = 1; j <= k; j++) {
+      table[k][j] = j * (table[k - 1][j] + table[k - 1][j - 1]);
+    }
+  }
+  return table;
+}
+
+/**
+ * @brief forward differences of a polynomial at t with step h
+ *
+ * Returns p(t) followed by its first to last forward differences. They are
+ * derived from the polynomial's Taylor coefficients at t instead of by
+ * subtracting nearby values, so the small higher differences keep their full
+ * precision.
+ *
+ * @param coeffs polynomial coefficients, highest degree first
+ */
+template <std::floating_point Float, size_t N>
+inline std::array<Float, N> forward_differences(std::array<Float, N> coeffs,
+                                                Float t, Float h) {
+  static constexpr auto surjections = surjection_table<Float, N>();
+
+  // Taylor shift to t, leaves coeffs[N - 1 - k] as the coefficient of u^k in
+  // p(t + u)
+  for (size_t i = 0; i + 1 < N; i++) {
+    for (size_t j = 1; j < N - i; j++) {
+      coeffs[j] += t * coeffs[j - 1];
+    }
+  }
+
+  // coefficients of q(u) = p(t + h u), lowest degree first
+  std::array<Float, N> b;
+  Float power = 1;
+  for (size_t k = 0; k < N; k++) {
+    b[k] = coeffs[N - 1 - k] * power;
+    power *= h;
+  }
+
+  std::array<Float, N> differences{};
+  for (size_t j = 0; j < N; j++) {
+    for (size_t k = j; k < N; k++) {
+      differences[j] += b[k] * surjections[k][j];
+    }
+  }
+  return differences;
+}
+
+/**
+ * @brief converts forward differences with step h into ones with step L h
+ *
+ * With E the shift by h and D = E - 1, the j-th difference with step L h is
+ * (E^L - 1)^j = ((1 + D)^L - 1)^j. Expanding it in powers of D (which
+ * vanish from the polynomial's degree on) gives row j of the matrix.
+ */
+template <std::floating_point Float, size_t N, size_t L>
+constexpr std::array<std::array<Float, N>, N> lane_step_matrix() {
+  // (1 + D)^L - 1, truncated to degree N - 1
+  std::array<Float, N> step{};
+  Float binomial = 1;
+  for (size_t i = 1; i < N && i <= L; i++) {
+    binomial = binomial * (L - i + 1) / i;
+    step[i] = binomial;
+  }
+
+  std::array<std::array<Float, N>, N> matrix{};
+  matrix[0][0] = 1;
+  for (size_t j = 1; j < N; j++) {
+    for (size_t a = 0; a < N; a++) {
+      for (size_t b = 1; a + b < N; b++) {
+        matrix[j][a + b] += matrix[j - 1][a] * step[b];
+      }
+    }
+  }
+  return matrix;
+}
+
+// lanes interleaved difference tables, indexed [difference][lane]
+template <std::floating_point Float, size_t N, size_t Lanes>
+using LaneDifferences = std::array<std::array<Float, Lanes>, N>;
+
+/**
+ * @brief steps interleaved forward difference tables over rows of samples
+ *
+ * Kept apart from the anchoring so the tables are plain locals the compiler
+ * can hold in vector registers. Fully unrolled, so the lanes become straight
+ * line code that gets packed into vector adds.
+ */
+template <std::floating_point Float, size_t N, size_t Lanes>
+// not inlined into the anchoring, which otherwise keeps the tables in memory
+[[gnu::noinline]] void forward_difference_rows(LaneDifferences<Float, N, Lanes> dx,
+                                    LaneDifferences<Float, N, Lanes> dy,
+                                    size_t rows, Float *__restrict x,
+                                    Float *__restrict y) {
+  for (size_t r = 0; r < rows; r++) {
+    Float *__restrict xr = x + r * Lanes;
+    Float *__restrict yr = y + r * Lanes;
+#pragma GCC unroll 8
+    for (size_t k = 0; k < Lanes; k++) {
+      xr[k] = dx[0][k];
+      yr[k] = dy[0][k];
+    }
+#pragma GCC unroll 8
+    for (size_t j = 0; j + 1 < N; j++) {
+#pragma GCC unroll 8
+      for (size_t k = 0; k < Lanes; k++) {
+        dx[j][k] += dx[j + 1][k];
+        dy[j][k] += dy[j + 1][k];
+      }
+    }
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief evaluates a polynomial with vector coefficients at uniform steps
+ *
+ * Forward differencing produces each sample with one addition per
+ * coefficient instead of a full Horner evaluation. A single difference
+ * table is a serial chain that can't be vectorized, so the samples are dealt
+ * round robin to a handful of interleaved tables (lanes), each stepping over
+ * the others' samples, and the compiler vectorizes across lanes.
+ *
+ * The tables are recomputed exactly every anchor_interval samples, so
+ * rounding drift can only build up over a bounded number of steps (for
+ * float, errors stay within a few ulps of the curve's extent). Samples left
+ * over at the end that don't fill a row of lanes, and runs too short to pay
+ * for setting up the tables, are evaluated with Horner's method.
+ *
+ * @param coeffs polynomial coefficients, highest degree first
+ * @param t0 time of the first sample
+ * @param dt step between samples
+ * @param n number of samples
+ * @param x output x values, must hold n scalars
+ * @param y output y values, must hold n scalars
+ * @param anchor_interval number of samples between exact re-evaluations
+ */
+template <std::floating_point Float, typename Vector, size_t N>
+inline void forward_difference_batch(const std::array<Vector, N> &coeffs,
+                                     Float t0, Float dt, size_t n,
+                                     Float *__restrict x, Float *__restrict y,
+                                     size_t anchor_interval = 1024) {
+  static_assert(N > 0, "polynomial needs at least one coefficient");
+  constexpr size_t lanes = 8;
+  // whole rows of lanes per anchor
+  const size_t block =
+      std::max<size_t>((anchor_interval + lanes - 1) / lanes, 1) * lanes;
+
+  std::array<Float, N> cx, cy;
+  for (size_t j = 0; j < N; j++) {
+    cx[j] = coeffs[j].x.internal();
+    cy[j] = coeffs[j].y.internal();
+  }
+
+  // short runs don't pay for setting up the tables
+  const size_t min_rows = 4 * N;
+
+  for (size_t start = 0; start < n; start += block) {
+    const size_t count = std::min(block, n - start);
+    const size_t rows = count / lanes >= min_rows ? count / lanes : 0;
+
+    // lane k starts at sample start + k and steps over lanes samples at a
+    // time
+    detail::LaneDifferences<Float, N, lanes> dx, dy;
+    if (rows > 0) {
+      // one exact table with step dt, walked across the lanes and converted
+      // to step lanes * dt at each of them
+      static constexpr auto to_lane_step =
+          detail::lane_step_matrix<Float, N, lanes>();
+      std::array<Float, N> sx =
+          detail::forward_differences(cx, t0 + start * dt, dt);
+      std::array<Float, N> sy =
+          detail::forward_differences(cy, t0 + start * dt, dt);
+      for (size_t k = 0; k < lanes; k++) {
+        for (size_t j = 0; j < N; j++) {
+          dx[j][k] = dy[j][k] = 0;
+          for (size_t i = j; i < N; i++) {
+            dx[j][k] += to_lane_step[j][i] * sx[i];
+            dy[j][k] += to_lane_step[j][i] * sy[i];
+          }
+        }
+        for (size_t j = 0; j + 1 < N; j++) {
+          sx[j] += sx[j + 1];
+          sy[j] += sy[j + 1];
+        }
+      }
+
+      // only once the tables are filled, they're passed by value
+      detail::forward_difference_rows(dx, dy, rows, x + start, y + start);
+    }
+
+    const size_t end = start + count;
+    for (size_t i = start + rows * lanes; i < end; i++) {
+      const Float t = t0 + i * dt;
+      Float rx = cx[0];
+      Float ry = cy[0];
+#pragma GCC unroll 8
+      for (size_t j = 1; j < N; j++) {
+        rx = rx * t + cx[j];
+        ry = ry * t + cy[j];
+      }
+      x[i] = rx;
+      y[i] = ry;
+    }
+  }
+}
+
+} // namespace geometry
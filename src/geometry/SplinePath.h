@@ -0,0 +1,259 @@
+#pragma once
+
+#include "Bezier.h"
+#include "Curve.h"
+#include "QuinticBezier.h"
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace geometry {
+
+// continuity enforced at the joins between path segments
+enum class Continuity {
+  // segments share their endpoints
+  C0,
+  // first derivatives match at the joins
+  C1,
+  // first and second derivatives match at the joins
+  C2,
+};
+
+/**
+ * @brief chain of curve segments indexed by global arc length
+ *
+ * Keeps a prefix sum of the segment lengths, so finding the segment that
+ * contains a distance along the path is a binary search instead of a walk
+ * over every segment.
+ *
+ * @tparam Float scalar type of the segments
+ */
+template <std::floating_point Float> class BasicSplinePath {
+public:
+  using CurveType = BasicCurve<Float>;
+  using LengthType = typename CurveType::LengthType;
+  using PointType = typename CurveType::PointType;
+
+  // position on the path as a segment and a time within that segment
+  struct Location {
+    size_t segment;
+    Float t;
+  };
+
+  // difference between the two sides of a join
+  struct JoinError {
+    LengthType position;
+    LengthType derivative;
+    LengthType second_derivative;
+  };
+
+  BasicSplinePath() = default;
+
+  // appends a segment to the end of the path
+  void append(std::unique_ptr<CurveType> segment) {
+    const LengthType start = total_distance();
+    m_segments.push_back(std::move(segment));
+    m_start.push_back(start + m_segments.back()->total_distance());
+  }
+
+  size_t size() const { return m_segments.size(); }
+
+  bool empty() const { return m_segments.empty(); }
+
+  CurveType &segment(size_t i) { return *m_segments[i]; }
+
+  const CurveType &segment(size_t i) const { return *m_segments[i]; }
+
+  // length of the whole path
+  LengthType total_distance() const { return m_start.back(); }
+
+  // distance along the path at which segment i starts
+  LengthType start_distance(size_t i) const { return m_start[i]; }
+
+  /**
+   * @brief refreshes the distance index after segments were edited
+   *
+   * Only the prefix sums from segment first onwards are recomputed.
+   *
+   * @param first first segment whose length may have changed
+   */
+  void update(size_t first = 0) {
+    for (size_t i = first; i < m_segments.size(); i++) {
+      m_start[i + 1] = m_start[i] + m_segments[i]->total_distance();
+    }
+  }
+
+  /**
+   * @brief finds the segment and local time at a distance along the path
+   *
+   * @param s distance from the start of the path, clamped to the path
+   * @return segment containing s and the time within that segment
+   */
+  Location t_by_s(LengthType s) {
+    if (m_segments.empty())
+      return {0, 0};
+
+    // first segment starting after s, s lies in the one before
+    auto upper = std::upper_bound(m_start.begin() + 1, m_start.end() - 1, s);
+    const size_t i = upper - m_start.begin() - 1;
+
+    const LengthType local = s - m_start[i];
+    if (local <= LengthType(0.0))
+      return {i, 0};
+    if (local >= m_segments[i]->total_distance())
+      return {i, 1};
+    return {i, m_segments[i]->t_by_s(local)};
+  }
+
+  // distance along the path at a location
+  LengthType s(Location location) {
+    return m_start[location.segment] +
+           m_segments[location.segment]->s(location.t);
+  }
+
+  // point on the path at a location
+  PointType f(Location location) {
+    return m_segments[location.segment]->f(location.t);
+  }
+
+  // point on the path at a distance from its start
+  PointType f(LengthType s) { return f(t_by_s(s)); }
+
+  /**
+   * @brief measures how far a join is from being continuous
+   *
+   * @param join index of the segment after the join, in [1, size())
+   * @return magnitude of the jump in position, first and second derivative
+   */
+  JoinError continuityError(size_t join) {
+    CurveType &before = *m_segments[join - 1];
+    CurveType &after = *m_segments[join];
+    return {(after.f(0) - before.f(1)).magnitude(),
+            (after.df(0) - before.df(1)).magnitude(),
+            (after.ddf(0) - before.ddf(1)).magnitude()};
+  }
+
+  /**
+   * @brief moves control points so every join has the given continuity
+   *
+   * Each segment is adjusted to match the one before it, so the first
+   * segment is left as is. For C1 the first control point of the next
+   * segment is placed to match the first derivative at the end of the
+   * previous segment, and for C2 its second control point is also placed to
+   * match the second derivative. Cubic and quintic bezier segments can be
+   * adjusted, other segment types are skipped. Only quintics keep their own
+   * shape at their far end under C2, cubics have no control points left.
+   *
+   * @param continuity continuity to enforce
+   */
+  void enforceContinuity(Continuity continuity) {
+    for (size_t i = 1; i < m_segments.size(); i++) {
+      const EndState end = end_state(*m_segments[i - 1]);
+
+      if (auto *after =
+              dynamic_cast<BasicCubicBezier<Float> *>(m_segments[i].get())) {
+        std::array<Point, 4> next = after->getControlPoints();
+        match(next, end, continuity, 3);
+        after->updateBezierEndpoints(next);
+      } else if (auto *after = dynamic_cast<BasicQuinticBezier<Float> *>(
+                     m_segments[i].get())) {
+        std::array<Point, 6> next = after->getControlPoints();
+        match(next, end, continuity, 5);
+        after->updateBezierEndpoints(next);
+      }
+    }
+    update();
+  }
+
+  /**
+   * @brief inserts a waypoint by splitting a segment in two
+   *
+   * Only the halves are integrated. The later segments keep their lengths
+   * and are shifted by the difference between the halves and the old
+   * segment, in the same pass that makes room for the new start.
+   *
+   * @param location segment to split and time to split it at
+   * @return whether the segment could be split, only beziers can
+   */
+  bool insert(Location location) {
+    auto [left, right] = split_segment(*m_segments[location.segment],
+                                       location.t);
+    if (!left)
+      return false;
+
+    const size_t i = location.segment;
+    const LengthType shift = left->total_distance() +
+                             right->total_distance() -
+                             (m_start[i + 1] - m_start[i]);
+    for (size_t j = i + 1; j < m_start.size(); j++)
+      m_start[j] += shift;
+    m_start.insert(m_start.begin() + i + 1,
+                   m_start[i] + left->total_distance());
+    m_segments[i] = std::move(left);
+    m_segments.insert(m_segments.begin() + i + 1, std::move(right));
+    return true;
+  }
+
+private:
+  using Halves =
+      std::pair<std::unique_ptr<CurveType>, std::unique_ptr<CurveType>>;
+
+  static Halves split_segment(CurveType &segment, Float t) {
+    if (auto *cubic = dynamic_cast<BasicCubicBezier<Float> *>(&segment)) {
+      auto [left, right] = cubic->split(t);
+      return {std::make_unique<BasicCubicBezier<Float>>(std::move(left)),
+              std::make_unique<BasicCubicBezier<Float>>(std::move(right))};
+    }
+    if (auto *quintic = dynamic_cast<BasicQuinticBezier<Float> *>(&segment)) {
+      auto [left, right] = quintic->split(t);
+      return {std::make_unique<BasicQuinticBezier<Float>>(std::move(left)),
+              std::make_unique<BasicQuinticBezier<Float>>(std::move(right))};
+    }
+    return {};
+  }
+
+  // position and derivatives at the end of a segment
+  struct EndState {
+    Point position;
+    Point derivative;
+    Point second_derivative;
+  };
+
+  // read from the control points of beziers so joins stay exact in double
+  static EndState end_state(CurveType &segment) {
+    if (auto *cubic = dynamic_cast<BasicCubicBezier<Float> *>(&segment)) {
+      const std::array<Point, 4> p = cubic->getControlPoints();
+      return {p[3], (p[3] - p[2]) * 3.0, (p[3] - p[2] * 2.0 + p[1]) * 6.0};
+    }
+    if (auto *quintic = dynamic_cast<BasicQuinticBezier<Float> *>(&segment)) {
+      const std::array<Point, 6> p = quintic->getControlPoints();
+      return {p[5], (p[5] - p[4]) * 5.0, (p[5] - p[4] * 2.0 + p[3]) * 20.0};
+    }
+    return {segment.endpoints[1], Point(segment.df(1)), Point(segment.ddf(1))};
+  }
+
+  // places the first controls of a bezier of the given degree to match end
+  template <size_t N>
+  static void match(std::array<Point, N> &controls, const EndState &end,
+                    Continuity continuity, double degree) {
+    controls[0] = end.position;
+    if (continuity != Continuity::C0)
+      controls[1] = controls[0] + end.derivative / degree;
+    // the second derivative at the start is n (n - 1) (P2 - 2 P1 + P0)
+    if (continuity == Continuity::C2)
+      controls[2] = end.second_derivative / (degree * (degree - 1)) +
+                    controls[1] * 2.0 - controls[0];
+  }
+
+  std::vector<std::unique_ptr<CurveType>> m_segments;
+  // distance at which each segment starts, with the total length at the end
+  std::vector<LengthType> m_start{LengthType(0.0)};
+};
+
+using SplinePath = BasicSplinePath<float>;
+using DSplinePath = BasicSplinePath<double>;
+
+} // namespace geometry
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../utils.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace geometry {
+
+/**
+ * @brief splits bezier control points at time t with de Casteljau's algorithm
+ *
+ * Works for any degree. Both halves are exact, the left one covers [0, t] and
+ * the right one [t, 1] of the original curve, each reparameterized to [0, 1].
+ *
+ * @param controls control points of the curve
+ * @param t time to split at
+ * @return controls of the left and right halves
+ */
+template <size_t N>
+std::pair<std::array<Point, N>, std::array<Point, N>>
+split_controls(const std::array<Point, N> &controls, double t) {
+  std::array<Point, N> left, right;
+  std::array<Point, N> points = controls;
+  for (size_t level = 0; level < N; level++) {
+    left[level] = points[0];
+    right[N - 1 - level] = points[N - 1 - level];
+    for (size_t i = 0; i + 1 < N - level; i++) {
+      points[i] = points[i] + (points[i + 1] - points[i]) * t;
+    }
+  }
+  return {left, right};
+}
+
+/**
+ * @brief control points of the part of a bezier between times t0 and t1
+ *
+ * @param controls control points of the curve
+ * @param t0 start of the part, t0 > t1 gives the part reversed
+ * @param t1 end of the part
+ * @return controls of the part, reparameterized to [0, 1]
+ */
+template <size_t N>
+std::array<Point, N> subcurve_controls(const std::array<Point, N> &controls,
+                                       double t0, double t1) {
+  if (t0 > t1) {
+    std::array<Point, N> reversed = subcurve_controls(controls, t1, t0);
+    std::reverse(reversed.begin(), reversed.end());
+    return reversed;
+  }
+
+  // the right part of the split at t0, then the left part of that at the
+  // end time rescaled to it
+  const std::array<Point, N> tail = split_controls(controls, t0).second;
+  if (t0 >= 1)
+    return tail;
+  return split_controls(tail, (t1 - t0) / (1 - t0)).first;
+}
+
+namespace detail {
+
+// curves with bezier control points, every piece of which lies in the convex
+// hull of its own control points
+template <typename C>
+concept ControlPointCurve = requires(C &curve) {
+  geometry::subcurve_controls(curve.getControlPoints(), 0.0, 1.0);
+};
+
+} // namespace detail
+
+} // namespace geometry
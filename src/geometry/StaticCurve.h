@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Curve.h"
+#include "Samples.h"
+#include <concepts>
+#include <span>
+
+namespace geometry {
+
+/**
+ * @brief static counterpart of the Curve interface
+ *
+ * Generic algorithms (samplers, profilers, projections) are templated on this
+ * concept instead of taking a Curve &, so when they are instantiated with a
+ * concrete (final) curve type the small polynomial kernels get inlined into
+ * the hot loop. Instantiating them with Curve itself still works and goes
+ * through the vtable, which is what the GUI uses.
+ */
+template <typename C>
+concept StaticCurve =
+    std::floating_point<typename C::Scalar> &&
+    requires(C &curve, typename C::Scalar t, typename C::LengthType s,
+             typename C::PointType p) {
+      { curve.f(t) } -> std::convertible_to<typename C::PointType>;
+      { curve.df(t) } -> std::convertible_to<typename C::PointType>;
+      { curve.ddf(t) } -> std::convertible_to<typename C::PointType>;
+      { curve.dddf(t) } -> std::convertible_to<typename C::PointType>;
+      { curve.c(t) } -> std::convertible_to<typename C::CurvatureType>;
+      { curve.c(t, p) } -> std::convertible_to<typename C::CurvatureType>;
+      { curve.s(t) } -> std::convertible_to<typename C::LengthType>;
+      { curve.s(t, t) } -> std::convertible_to<typename C::LengthType>;
+      { curve.t_by_s(s) } -> std::convertible_to<typename C::Scalar>;
+      { curve.t_by_s(s, t) } -> std::convertible_to<typename C::Scalar>;
+    };
+
+static_assert(StaticCurve<Curve>);
+static_assert(StaticCurve<DCurve>);
+
+/**
+ * @brief samples the position of a curve at every time in t
+ *
+ * Scalar counterpart of Curve::f_batch for curves without a vectorized
+ * evaluator, values are written in internal units.
+ *
+ * @param curve curve to sample
+ * @param t times at which to sample
+ * @param out buffer resized to t.size() and filled with positions
+ */
+template <StaticCurve C>
+inline void sample(C &curve, std::span<const typename C::Scalar> t,
+                   BasicCurveSamples<typename C::Scalar> &out) {
+  out.resize(t.size());
+  for (size_t i = 0; i < t.size(); i++) {
+    const typename C::PointType p = curve.f(t[i]);
+    out.x[i] = p.x.internal();
+    out.y[i] = p.y.internal();
+  }
+}
+
+/**
+ * @brief samples the curvature of a curve at every time in t
+ *
+ * @param curve curve to sample
+ * @param t times at which to sample
+ * @param out filled with the curvature at each time, in internal units
+ */
+template <StaticCurve C>
+inline void sample_curvature(C &curve, std::span<const typename C::Scalar> t,
+                             std::vector<typename C::Scalar> &out) {
+  out.resize(t.size());
+  for (size_t i = 0; i < t.size(); i++) {
+    out[i] = curve.c(t[i]).internal();
+  }
+}
+
+} // namespace geometry
@@ -0,0 +1,663 @@
+#pragma once
+
+#include "Curve.h"
+#include "units/Pose.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <vector>
+
+namespace geometry {
+
+namespace detail {
+
+/**
+ * @brief shortest word of arcs and lines, for a turning radius of 1
+ *
+ * Turns are +1 for left, 0 for straight and -1 for right. Lengths are
+ * radians on arcs and radii on lines, negative where the robot reverses.
+ */
+struct TurnWord {
+  std::array<int, 5> turns{};
+  std::array<double, 5> lengths{};
+  size_t size = 0;
+
+  double length() const {
+    double sum = 0;
+    for (size_t i = 0; i < size; i++) {
+      sum += std::abs(lengths[i]);
+    }
+    return sum;
+  }
+
+  // word that is no solution, longer than any real one
+  static TurnWord none() {
+    TurnWord word;
+    word.lengths[0] = std::numeric_limits<double>::infinity();
+    word.size = 1;
+    return word;
+  }
+};
+
+// angle in [0, 2 pi)
+inline double wrap_positive(double angle) {
+  angle = std::fmod(angle, 2 * std::numbers::pi);
+  return angle < 0 ? angle + 2 * std::numbers::pi : angle;
+}
+
+// angle in [-pi, pi]
+inline double wrap(double angle) {
+  angle = std::fmod(angle, 2 * std::numbers::pi);
+  if (angle < -std::numbers::pi)
+    return angle + 2 * std::numbers::pi;
+  if (angle > std::numbers::pi)
+    return angle - 2 * std::numbers::pi;
+  return angle;
+}
+
+/**
+ * @brief shortest forward only path (Dubins 1957)
+ *
+ * Uses the closed forms of Shkel and Lumelsky for the six candidate words,
+ * with the goal on the x axis at distance d and both headings measured from
+ * the line between start and goal.
+ *
+ * @param alpha start heading
+ * @param beta goal heading
+ * @param d distance between start and goal
+ */
+inline TurnWord dubins_word(double alpha, double beta, double d) {
+  const double sa = std::sin(alpha), sb = std::sin(beta);
+  const double ca = std::cos(alpha), cb = std::cos(beta);
+  const double c_ab = std::cos(alpha - beta);
+  const double d2 = d * d;
+
+  TurnWord best = TurnWord::none();
+  auto consider = [&best](std::array<int, 5> turns, double t, double p,
+                          double q) {
+    const TurnWord word{turns, {t, p, q}, 3};
+    if (word.length() < best.length())
+      best = word;
+  };
+
+  // LSL
+  double p2 = 2 + d2 - 2 * c_ab + 2 * d * (sa - sb);
+  if (p2 >= 0) {
+    const double theta = std::atan2(cb - ca, d + sa - sb);
+    consider({1, 0, 1}, wrap_positive(theta - alpha), std::sqrt(p2),
+             wrap_positive(beta - theta));
+  }
+
+  // RSR
+  p2 = 2 + d2 - 2 * c_ab + 2 * d * (sb - sa);
+  if (p2 >= 0) {
+    const double theta = std::atan2(ca - cb, d - sa + sb);
+    consider({-1, 0, -1}, wrap_positive(alpha - theta), std::sqrt(p2),
+             wrap_positive(theta - beta));
+  }
+
+  // LSR
+  p2 = -2 + d2 + 2 * c_ab + 2 * d * (sa + sb);
+  if (p2 >= 0) {
+    const double p = std::sqrt(p2);
+    const double theta =
+        std::atan2(-ca - cb, d + sa + sb) - std::atan2(-2.0, p);
+    consider({1, 0, -1}, wrap_positive(theta - alpha), p,
+             wrap_positive(theta - beta));
+  }
+
+  // RSL
+  p2 = -2 + d2 + 2 * c_ab - 2 * d * (sa + sb);
+  if (p2 >= 0) {
+    const double p = std::sqrt(p2);
+    const double theta = std::atan2(ca + cb, d - sa - sb) - std::atan2(2.0, p);
+    consider({-1, 0, 1}, wrap_positive(alpha - theta), p,
+             wrap_positive(beta - theta));
+  }
+
+  // RLR
+  double cos_p = (6 - d2 + 2 * c_ab + 2 * d * (sa - sb)) / 8;
+  if (std::abs(cos_p) <= 1) {
+    const double p = wrap_positive(2 * std::numbers::pi - std::acos(cos_p));
+    const double t =
+        wrap_positive(alpha - std::atan2(ca - cb, d - sa + sb) + p / 2);
+    consider({-1, 1, -1}, t, p, wrap_positive(alpha - beta - t + p));
+  }
+
+  // LRL
+  cos_p = (6 - d2 + 2 * c_ab + 2 * d * (sb - sa)) / 8;
+  if (std::abs(cos_p) <= 1) {
+    const double p = wrap_positive(2 * std::numbers::pi - std::acos(cos_p));
+    const double t =
+        wrap_positive(-alpha - std::atan2(ca - cb, d + sa - sb) + p / 2);
+    consider({1, -1, 1}, t, p, wrap_positive(beta - alpha - t + p));
+  }
+  return best;
+}
+
+/**
+ * @brief shortest path with reversing (Reeds and Shepp 1990)
+ *
+ * Follows the formulas of Reeds and Shepp as corrected by Souères and
+ * Laumond. Each base word starts with a left turn forwards; the other
+ * words of its family follow by the symmetries of the problem: running
+ * the path backwards in time (negating x and the heading change) reverses
+ * every segment, reflecting across the x axis swaps left and right, and
+ * some families are also solved from the goal back to the start.
+ */
+struct ReedsShepp {
+  // how far below zero a length may be and still count as zero
+  static constexpr double zero = 10 * std::numeric_limits<double>::epsilon();
+  static constexpr double pi = std::numbers::pi;
+
+  TurnWord best = TurnWord::none();
+
+  static void polar(double x, double y, double &r, double &theta) {
+    r = std::hypot(x, y);
+    theta = std::atan2(y, x);
+  }
+
+  static void tau_omega(double u, double v, double xi, double eta, double phi,
+                        double &tau, double &omega) {
+    const double delta = wrap(u - v);
+    const double a = std::sin(u) - std::sin(delta);
+    const double b = std::cos(u) - std::cos(delta) - 1;
+    const double t1 = std::atan2(eta * a - xi * b, xi * a + eta * b);
+    const double t2 = 2 * (std::cos(delta) - std::cos(v) - std::cos(u)) + 3;
+    tau = t2 < 0 ? wrap(t1 + pi) : wrap(t1);
+    omega = wrap(tau - u + v - phi);
+  }
+
+  // formula 8.1, L+S+L+
+  static bool lsl(double x, double y, double phi, TurnWord &word) {
+    double t, u;
+    polar(x - std::sin(phi), y - 1 + std::cos(phi), u, t);
+    if (t < -zero)
+      return false;
+    const double v = wrap(phi - t);
+    word = {{1, 0, 1}, {t, u, v}, 3};
+    return v >= -zero;
+  }
+
+  // formula 8.2, L+S+R+
+  static bool lsr(double x, double y, double phi, TurnWord &word) {
+    double r, theta;
+    polar(x + std::sin(phi), y - 1 - std::cos(phi), r, theta);
+    if (r * r < 4)
+      return false;
+    const double u = std::sqrt(r * r - 4);
+    const double t = wrap(theta + std::atan2(2.0, u));
+    const double v = wrap(t - phi);
+    word = {{1, 0, -1}, {t, u, v}, 3};
+    return t >= -zero && v >= -zero;
+  }
+
+  // formula 8.3, L+R-L
+  static bool lrl(double x, double y, double phi, TurnWord &word) {
+    double r, theta;
+    polar(x - std::sin(phi), y - 1 + std::cos(phi), r, theta);
+    if (r > 4)
+      return false;
+    const double u = -2 * std::asin(r / 4);
+    const double t = wrap(theta + u / 2 + pi);
+    const double v = wrap(phi - t + u);
+    word = {{1, -1, 1}, {t, u, v}, 3};
+    return t >= -zero && u <= zero;
+  }
+
+  // formula 8.7, L+R+L-R-
+  static bool lrlr_meeting(double x, double y, double phi, TurnWord &word) {
+    const double xi = x + std::sin(phi), eta = y - 1 - std::cos(phi);
+    const double rho = (2 + std::hypot(xi, eta)) / 4;
+    if (rho > 1)
+      return false;
+    const double u = std::acos(rho);
+    double t, v;
+    tau_omega(u, -u, xi, eta, phi, t, v);
+    word = {{1, -1, 1, -1}, {t, u, -u, v}, 4};
+    return t >= -zero && v <= zero;
+  }
+
+  // formula 8.8, L+R-L-R+
+  static bool lrlr_parallel(double x, double y, double phi, TurnWord &word) {
+    const double xi = x + std::sin(phi), eta = y - 1 - std::cos(phi);
+    const double rho = (20 - xi * xi - eta * eta) / 16;
+    if (rho < 0 || rho > 1)
+      return false;
+    const double u = -std::acos(rho);
+    if (u < -pi / 2)
+      return false;
+    double t, v;
+    tau_omega(u, u, xi, eta, phi, t, v);
+    word = {{1, -1, 1, -1}, {t, u, u, v}, 4};
+    return t >= -zero && v >= -zero;
+  }
+
+  // formula 8.9, L+R-S-L-
+  static bool lrsl(double x, double y, double phi, TurnWord &word) {
+    double rho, theta;
+    polar(x - std::sin(phi), y - 1 + std::cos(phi), rho, theta);
+    if (rho < 2)
+      return false;
+    const double r = std::sqrt(rho * rho - 4);
+    const double u = 2 - r;
+    const double t = wrap(theta + std::atan2(r, -2.0));
+    const double v = wrap(phi - pi / 2 - t);
+    word = {{1, -1, 0, 1}, {t, -pi / 2, u, v}, 4};
+    return t >= -zero && u <= zero && v <= zero;
+  }
+
+  // formula 8.10, L+R-S-R-
+  static bool lrsr(double x, double y, double phi, TurnWord &word) {
+    const double xi = x + std::sin(phi), eta = y - 1 - std::cos(phi);
+    double rho, theta;
+    polar(-eta, xi, rho, theta);
+    if (rho < 2)
+      return false;
+    const double t = theta;
+    const double u = 2 - rho;
+    const double v = wrap(t + pi / 2 - phi);
+    word = {{1, -1, 0, -1}, {t, -pi / 2, u, v}, 4};
+    return t >= -zero && u <= zero && v <= zero;
+  }
+
+  // formula 8.11, L+R-S-L-R+
+  static bool lrslr(double x, double y, double phi, TurnWord &word) {
+    const double xi = x + std::sin(phi), eta = y - 1 - std::cos(phi);
+    double rho, theta;
+    polar(xi, eta, rho, theta);
+    if (rho < 2)
+      return false;
+    const double u = 4 - std::sqrt(rho * rho - 4);
+    if (u > zero)
+      return false;
+    const double t = wrap(
+        std::atan2((4 - u) * xi - 2 * eta, -2 * xi + (u - 4) * eta));
+    const double v = wrap(t - phi);
+    word = {{1, -1, 0, 1, -1}, {t, -pi / 2, u, -pi / 2, v}, 5};
+    return t >= -zero && v >= -zero;
+  }
+
+  /**
+   * @brief tries a base word under every symmetry, keeping the shortest
+   *
+   * @param backwards solve from the goal back to the start, which reverses
+   * the order of the segments
+   */
+  template <typename Word>
+  void consider(double x, double y, double phi, bool backwards, Word word) {
+    if (backwards) {
+      const double xb = x * std::cos(phi) + y * std::sin(phi);
+      const double yb = x * std::sin(phi) - y * std::cos(phi);
+      x = xb;
+      y = yb;
+    }
+
+    for (bool flip : {false, true}) {
+      for (bool reflect : {false, true}) {
+        TurnWord candidate;
+        if (!word(flip ? -x : x, reflect ? -y : y, flip != reflect ? -phi : phi,
+                   candidate))
+          continue;
+
+        for (size_t i = 0; i < candidate.size; i++) {
+          if (flip)
+            candidate.lengths[i] = -candidate.lengths[i];
+          if (reflect)
+            candidate.turns[i] = -candidate.turns[i];
+        }
+        if (backwards) {
+          std::reverse(candidate.turns.begin(),
+                       candidate.turns.begin() + candidate.size);
+          std::reverse(candidate.lengths.begin(),
+                       candidate.lengths.begin() + candidate.size);
+        }
+        if (candidate.length() < best.length())
+          best = candidate;
+      }
+    }
+  }
+
+  /**
+   * @param x goal position in the start frame
+   * @param y goal position in the start frame
+   * @param phi goal heading relative to the start heading
+   */
+  ReedsShepp(double x, double y, double phi) {
+    // CSC
+    consider(x, y, phi, false, lsl);
+    consider(x, y, phi, false, lsr);
+    // CCC
+    consider(x, y, phi, false, lrl);
+    consider(x, y, phi, true, lrl);
+    // CCCC
+    consider(x, y, phi, false, lrlr_meeting);
+    consider(x, y, phi, false, lrlr_parallel);
+    // CCSC and CSCC
+    consider(x, y, phi, false, lrsl);
+    consider(x, y, phi, false, lrsr);
+    consider(x, y, phi, true, lrsl);
+    consider(x, y, phi, true, lrsr);
+    // CCSCC
+    consider(x, y, phi, false, lrslr);
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief path of circular arcs and straight lines with a minimum turning
+ * radius
+ *
+ * Built by the Dubins (forward only) and Reeds-Shepp (forward and reverse)
+ * generators, which find the shortest such path between two poses. They are
+ * cheap seeds for trajectory optimization and quick checks of whether a
+ * robot can get somewhere at all.
+ *
+ * Time is proportional to the distance travelled, so s() and t_by_s() are
+ * exact and need no integration. Where the path reverses, the derivative
+ * points backwards along the robot; heading() gives the way the robot
+ * faces.
+ *
+ * @tparam Float scalar type, float or double
+ */
+template <std::floating_point Float>
+class BasicTurnPath final : public BasicCurve<Float> {
+public:
+  using Base = BasicCurve<Float>;
+  using typename Base::Box;
+  using typename Base::CurvatureType;
+  using typename Base::LengthType;
+  using typename Base::PointType;
+
+  using Base::bounds;
+  using Base::endpoints;
+
+  // arc or line of the path
+  struct Segment {
+    // +1 turns left, 0 goes straight, -1 turns right
+    int turn;
+    // distance travelled in meters, negative when reversing
+    Float length;
+  };
+
+  /**
+   * @brief path following segments from a start pose
+   *
+   * @param start pose the path starts at
+   * @param radius turning radius of every arc
+   * @param segments arcs and lines, in order
+   */
+  BasicTurnPath(const Pose &start, Length radius,
+                std::vector<Segment> segments)
+      : Base(Point(start.x, start.y), Point(start.x, start.y)),
+        m_radius(radius.internal()), m_segments(std::move(segments)) {
+    State state{Float(start.x.internal()), Float(start.y.internal()),
+                Float(start.orientation.internal()), 0};
+    m_starts.reserve(m_segments.size() + 1);
+    for (const Segment &segment : m_segments) {
+      m_starts.push_back(state);
+      const State end = advance(state, segment, segment.length);
+      state = {end.x, end.y, end.heading,
+               state.distance + std::abs(segment.length)};
+    }
+    m_starts.push_back(state);
+    m_length = state.distance;
+    endpoints[1] = Point(state.x * m, state.y * m);
+  }
+
+  /**
+   * @brief shortest forward only path between two poses
+   *
+   * @param start pose the robot starts at
+   * @param end pose the robot ends at
+   * @param radius minimum turning radius
+   */
+  static BasicTurnPath dubins(const Pose &start, const Pose &end,
+                              Length radius) {
+    const double r = radius.internal();
+    const double dx = (end.x - start.x).internal() / r;
+    const double dy = (end.y - start.y).internal() / r;
+    const double theta = std::atan2(dy, dx);
+    const detail::TurnWord word = detail::dubins_word(
+        detail::wrap_positive(start.orientation.internal() - theta),
+        detail::wrap_positive(end.orientation.internal() - theta),
+        std::hypot(dx, dy));
+    return BasicTurnPath(start, radius, segments(word, r));
+  }
+
+  /**
+   * @brief shortest path between two poses, reversing where it helps
+   *
+   * @param start pose the robot starts at
+   * @param end pose the robot ends at
+   * @param radius minimum turning radius
+   */
+  static BasicTurnPath reeds_shepp(const Pose &start, const Pose &end,
+                                   Length radius) {
+    const double r = radius.internal();
+    const double heading = start.orientation.internal();
+    const double dx = (end.x - start.x).internal();
+    const double dy = (end.y - start.y).internal();
+    const double c = std::cos(heading), s = std::sin(heading);
+    const detail::ReedsShepp solver((c * dx + s * dy) / r,
+                                    (c * dy - s * dx) / r,
+                                    end.orientation.internal() - heading);
+    return BasicTurnPath(start, radius, segments(solver.best, r));
+  }
+
+  const std::vector<Segment> &segments() const { return m_segments; }
+
+  Length radius() const { return Length(double(m_radius)); }
+
+  // way the robot faces at time t, in radians, which is opposite to the
+  // derivative on segments that reverse
+  Float heading(Float t) const {
+    const Local local = locate(t);
+    if (local.segment == nullptr)
+      return m_starts.back().heading;
+    return local.start->heading + curvature(*local.segment) * local.u;
+  }
+
+  PointType f(Float t) override {
+    const Local local = locate(t);
+    if (local.segment == nullptr)
+      return point(m_starts.back().x, m_starts.back().y);
+    const State state = advance(*local.start, *local.segment, local.u);
+    return point(state.x, state.y);
+  }
+
+  PointType df(Float t) override {
+    const Local local = locate(t);
+    if (local.segment == nullptr)
+      return point(0, 0);
+    const Float theta =
+        local.start->heading + curvature(*local.segment) * local.u;
+    const Float scale = m_length * direction(*local.segment);
+    return point(scale * std::cos(theta), scale * std::sin(theta));
+  }
+
+  PointType ddf(Float t) override {
+    const Local local = locate(t);
+    if (local.segment == nullptr)
+      return point(0, 0);
+    const Float k = curvature(*local.segment);
+    const Float theta = local.start->heading + k * local.u;
+    const Float scale = m_length * m_length * k;
+    return point(-scale * std::sin(theta), scale * std::cos(theta));
+  }
+
+  PointType dddf(Float t) override {
+    const Local local = locate(t);
+    if (local.segment == nullptr)
+      return point(0, 0);
+    const Float k = curvature(*local.segment);
+    const Float theta = local.start->heading + k * local.u;
+    const Float scale =
+        -m_length * m_length * m_length * k * k * direction(*local.segment);
+    return point(scale * std::cos(theta), scale * std::sin(theta));
+  }
+
+  // curvature of the travelled path, flipped where the robot reverses
+  CurvatureType c(Float t) override {
+    const Local local = locate(t);
+    if (local.segment == nullptr)
+      return CurvatureType(0.0);
+    return CurvatureType(curvature(*local.segment) *
+                         direction(*local.segment));
+  }
+
+  CurvatureType c(Float t, PointType) override { return c(t); }
+
+  LengthType s(Float t) override { return LengthType(t * m_length); }
+
+  LengthType s(Float t0, Float t1) override {
+    return LengthType((t1 - t0) * m_length);
+  }
+
+  Float t_by_s(LengthType target, Float) override { return t_by_s(target); }
+
+  Float t_by_s(LengthType target) override {
+    if (m_length <= 0)
+      return 0;
+    return std::clamp(Float(target.internal() / m_length), Float(0),
+                      Float(1));
+  }
+
+  /**
+   * @brief exact axis aligned bounds of the path between times t0 and t1
+   *
+   * Arcs are extreme in x where they head straight up or down and in y where
+   * they head straight left or right, so besides the ends of every segment
+   * only those points are added.
+   *
+   * @param t0 start time
+   * @param t1 end time
+   * @return box in internal units
+   */
+  Box bounds(Float t0, Float t1) override {
+    Box box;
+    const Float lo =
+        std::clamp(std::min(t0, t1), Float(0), Float(1)) * m_length;
+    const Float hi =
+        std::clamp(std::max(t0, t1), Float(0), Float(1)) * m_length;
+    for (Float t : {t0, t1}) {
+      const PointType p = f(t);
+      box.expand(p.x.internal(), p.y.internal());
+    }
+
+    constexpr Float quarter = std::numbers::pi_v<Float> / 2;
+    for (size_t i = 0; i < m_segments.size(); i++) {
+      const State &start = m_starts[i];
+      const Segment &segment = m_segments[i];
+      const Float a = std::max(lo, start.distance);
+      const Float b = std::min(hi, m_starts[i + 1].distance);
+      if (a > b)
+        continue;
+
+      const Float k = curvature(segment);
+      const Float u0 = (a - start.distance) * direction(segment);
+      const Float u1 = (b - start.distance) * direction(segment);
+      for (Float u : {u0, u1}) {
+        const State state = advance(start, segment, u);
+        box.expand(state.x, state.y);
+      }
+      if (segment.turn == 0)
+        continue;
+
+      const Float theta0 = start.heading + k * u0;
+      const Float theta1 = start.heading + k * u1;
+      const Float first = std::ceil(std::min(theta0, theta1) / quarter);
+      const Float last = std::floor(std::max(theta0, theta1) / quarter);
+      for (Float j = first; j <= last; j++) {
+        const State state =
+            advance(start, segment, (j * quarter - start.heading) / k);
+        box.expand(state.x, state.y);
+      }
+    }
+    return box;
+  }
+
+private:
+  // pose and distance travelled at the start of a segment
+  struct State {
+    Float x;
+    Float y;
+    Float heading;
+    Float distance;
+  };
+
+  // segment at a time, and the signed distance u travelled into it
+  struct Local {
+    const Segment *segment;
+    const State *start;
+    Float u;
+  };
+
+  Float m_radius;
+  std::vector<Segment> m_segments;
+  // start of every segment, then the end of the path
+  std::vector<State> m_starts;
+  Float m_length = 0;
+
+  static std::vector<Segment> segments(const detail::TurnWord &word,
+                                       double radius) {
+    std::vector<Segment> result;
+    for (size_t i = 0; i < word.size; i++) {
+      // the solvers keep zero length segments, which would only get in the
+      // way of iterating the path
+      if (std::abs(word.lengths[i]) > 1e-12)
+        result.push_back({word.turns[i], Float(word.lengths[i] * radius)});
+    }
+    return result;
+  }
+
+  static PointType point(Float x, Float y) {
+    return PointType(LengthType(x * m), LengthType(y * m));
+  }
+
+  Float curvature(const Segment &segment) const {
+    return segment.turn / m_radius;
+  }
+
+  static Float direction(const Segment &segment) {
+    return segment.length < 0 ? -1 : 1;
+  }
+
+  // pose after driving u along a segment, backwards for negative u
+  State advance(const State &start, const Segment &segment, Float u) const {
+    if (segment.turn == 0)
+      return {start.x + u * std::cos(start.heading),
+              start.y + u * std::sin(start.heading), start.heading, 0};
+
+    const Float k = curvature(segment);
+    const Float theta = start.heading + k * u;
+    return {start.x + (std::sin(theta) - std::sin(start.heading)) / k,
+            start.y + (std::cos(start.heading) - std::cos(theta)) / k, theta,
+            0};
+  }
+
+  Local locate(Float t) const {
+    if (m_segments.empty())
+      return {nullptr, nullptr, 0};
+
+    const Float distance = std::clamp(t, Float(0), Float(1)) * m_length;
+    size_t i = 0;
+    while (i + 1 < m_segments.size() && m_starts[i + 1].distance <= distance)
+      i++;
+    const Float u = std::min(distance - m_starts[i].distance,
+                             std::abs(m_segments[i].length));
+    return {&m_segments[i], &m_starts[i], u * direction(m_segments[i])};
+  }
+
+  LengthType compute_total_distance() override {
+    return LengthType(m_length);
+  }
+};
+
+using TurnPath = BasicTurnPath<float>;
+using DTurnPath = BasicTurnPath<double>;
+
+} // namespace geometry
@@ -1,4 +1,6 @@
 #include "geometry/Bezier.h"
+#include "geometry/CurvePool.h"
+#include "geometry/QuinticBezier.h"
 #include "utils.h"
 
 #include "Bezier.h"
@@ -109,6 +111,36 @@ public:
     return model;
   }
 
+  // draws a quintic, which has no handles or sidebar card since only cubic
+  // control points can be edited
+  BezierModel *addBezier(geometry::QuinticBezier *bezier,
+                         BezierElementProperties properties) {
+    BezierModel *model = new BezierModel(bezier);
+
+    BezierView *view = new BezierView(model, m_fieldView, properties);
+
+    m_models.append(model);
+    m_views.append(view);
+
+    return model;
+  }
+
+  // adds a bezier allocated from the manager's curve pool, which owns it
+  BezierModel *addBezier(std::array<Point, 4> controls,
+                         BezierElementProperties properties) {
+    return addBezier(m_beziers.create(controls), properties);
+  }
+
+  // adds a quintic allocated from the manager's curve pool, which owns it
+  BezierModel *addBezier(std::array<Point, 6> controls,
+                         BezierElementProperties properties) {
+    return addBezier(m_quintics.create(controls), properties);
+  }
+
+  // makes room for count beziers before a bulk import, so they are allocated
+  // in one block
+  void reserveBeziers(size_t count) { m_beziers.reserve(count); }
+
   RobotModel *addRobot(Pose pose,
                          RobotElementProperties properties) {
     RobotModel *model = new RobotModel(pose);
@@ -143,6 +175,9 @@ public:
       c->deleteLater();
     }
     m_cards.clear();
+    // the models referencing pooled beziers are gone
+    m_beziers.clear();
+    m_quintics.clear();
   }
 
 private:
@@ -183,6 +218,8 @@ private:
   QList<ElementModel *> m_models;
   QList<ElementView *> m_views;
   QList<ComponentCard *> m_cards;
+  geometry::CurvePool<geometry::CubicBezier> m_beziers;
+  geometry::CurvePool<geometry::QuinticBezier> m_quintics;
 };
 
 class FieldWindow : public QWidget {
@@ -241,10 +278,10 @@ public:
     elementManager->addPoint(Point(-24_in, -24_in),
                              {.color = Qt::green, .movable = false});
 
-    auto test_bezier = new geometry::CubicBezier({0_in, 0_in}, {10_in, 0_in},
-                                                 {0_in, 10_in}, {24_in, 24_in});
-
-    elementManager->addBezier(test_bezier, {});
+    elementManager->addBezier(
+        std::array<Point, 4>{Point(0_in, 0_in), Point(10_in, 0_in),
+                             Point(0_in, 10_in), Point(24_in, 24_in)},
+        {});
     elementManager->addRobot({48_in,48_in,0_stDeg}, {});
 
     connect(add, &QPushButton::clicked, this,